@@ -0,0 +1,58 @@
+// Replacement global allocation functions for the allocation tracker. They live outside
+// any module so they replace the program-wide operator new/delete, as the standard requires.
+
+import <cstddef>;
+import <cstdlib>;
+import <new>;
+import alloc_tracker;
+
+#ifdef ARKANOID_ALLOC_TRACKING
+
+// The default array and nothrow forms forward to these
+void* operator new(std::size_t size) {
+    countAllocation(size);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    if (!memory) return;
+    countFree();
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    countAllocation(size);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+    void* memory = _aligned_malloc(size ? size : 1, align);
+#else
+    void* memory = std::aligned_alloc(align, (size / align + 1) * align);
+#endif
+    if (memory) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    if (!memory) return;
+    countFree();
+#ifdef _MSC_VER
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(memory, alignment);
+}
+
+#endif
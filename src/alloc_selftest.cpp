@@ -0,0 +1,82 @@
+module alloc_selftest;
+
+import <cstdint>;
+import <iostream>;
+import <optional>;
+import alloc_tracker;
+import ball;
+import collision_system;
+import gameplay_events;
+import gameplay_systems;
+import game_object_manager;
+import random_service;
+import worker_pool;
+import world_snapshot;
+
+namespace {
+    constexpr int warmupTicks = 3; // One per triple-buffered snapshot, as in PlayingState
+    constexpr int steadyTicks = 1200;
+    constexpr int stressBalls = 256;
+    constexpr float tickSeconds = 1.0f / 120.0f;
+}
+
+int runAllocationSelfTest(AudioManager& audioManager, const LevelConfig& level, unsigned workerThreads, std::uint64_t seed) {
+    if constexpr (!allocationTrackingEnabled) {
+        std::cerr << "Allocation self-test needs a build with ARKANOID_ALLOC_TRACKING (the DebugAlloc configuration)\n";
+        return 1;
+    }
+
+    // Creation logging is not part of the test
+    std::cout.setstate(std::ios_base::badbit);
+    WorkerPool pool(workerThreads);
+    GameObjectManager manager;
+    manager.setWorkerPool(&pool);
+    manager.reset(level.paddleWidth, level.ballSpeed, level.layout);
+    manager.spawnStressBalls(stressBalls, level.ballSpeed);
+    RandomService random(seed);
+    CollisionSystem collisionSystem(&pool);
+    GameplaySystems gameplaySystems(audioManager, random.stream(RandomStream::Gameplay));
+    GameplayEventQueue events;
+    TripleBuffer<WorldSnapshot> snapshots;
+    std::cout.clear();
+
+    std::cout << "Allocation self-test: " << stressBalls << " stress balls, " << workerThreads + 1 << " threads, "
+        << steadyTicks << " ticks after " << warmupTicks << " warmup ticks\n";
+    AllocationCounts start;
+    int ticks = 0;
+    for (; ticks < warmupTicks + steadyTicks; ++ticks) {
+        if (ticks == warmupTicks) {
+            // Process-wide, so allocations on the worker threads count too
+            start = processAllocationCounts();
+        }
+        std::optional<ZeroAllocationScope> steadyState;
+        if (ticks >= warmupTicks) {
+            steadyState.emplace("AllocSelfTest");
+        }
+        manager.update(tickSeconds);
+        events.clear();
+        collisionSystem.checkCollisions(manager, events);
+        gameplaySystems.process(events, manager);
+        if (manager.allDestructibleBlocksDestroyed()) {
+            break;
+        }
+        Ball* ball = manager.getBall();
+        if (ball->isOutOfBounds()) {
+            ball->reset(400, 300);
+        }
+        manager.captureSnapshot(snapshots.writeBuffer());
+        snapshots.publish();
+    }
+    AllocationCounts end = processAllocationCounts();
+
+    std::uint64_t allocations = end.allocations - start.allocations;
+    std::cout << "Steady-state ticks: " << ticks - warmupTicks << ", allocations: " << allocations
+        << " (" << end.bytes - start.bytes << " bytes)\n";
+    reportAllocationStats(std::cout);
+    if (ticks <= warmupTicks) {
+        std::cout << "ERROR: the level was cleared during warmup, nothing was measured\n";
+        return 1;
+    }
+    std::cout << (allocations == 0 ? "No allocations after warmup\n" : "ERROR: the simulation allocated after warmup\n");
+    return allocations == 0 ? 0 : 1;
+}
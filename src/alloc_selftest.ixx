@@ -0,0 +1,11 @@
+export module alloc_selftest;
+
+import audio;
+import config;
+import <cstdint>;
+
+// Headless zero-allocation check: builds level's scene with stress balls, runs the simulation
+// tick and the snapshot capture as PlayingState does, and counts heap allocations after the
+// warmup ticks. Returns 0 when none happened; needs a build with ARKANOID_ALLOC_TRACKING
+// (the DebugAlloc configuration) and fails without one.
+export int runAllocationSelfTest(AudioManager& audioManager, const LevelConfig& level, unsigned workerThreads, std::uint64_t seed);
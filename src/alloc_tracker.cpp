@@ -0,0 +1,169 @@
+module alloc_tracker;
+
+import <array>;
+import <atomic>;
+import <cstddef>;
+import <cstdio>;
+import <cstdlib>;
+import <iomanip>;
+import <mutex>;
+
+namespace {
+    // Plain counters: only the owning thread touches them, and they need no construction,
+    // so the first allocation of a new thread does not recurse into the tracker
+    struct ThreadCounters {
+        std::uint64_t allocations;
+        std::uint64_t bytes;
+        std::uint64_t frees;
+    };
+
+    thread_local ThreadCounters threadCounters;
+    thread_local int zeroAllocationDepth = 0;
+    thread_local const char* zeroAllocationName = nullptr;
+
+    std::atomic<std::uint64_t> totalAllocations{ 0 };
+    std::atomic<std::uint64_t> totalBytes{ 0 };
+    std::atomic<std::uint64_t> totalFrees{ 0 };
+    std::atomic<bool> assertionsEnabled{ false };
+
+    struct ZoneStats {
+        const char* name = nullptr;
+        bool zeroAllocation = false;
+        std::atomic<std::uint64_t> entries{ 0 };
+        std::atomic<std::uint64_t> allocations{ 0 };
+        std::atomic<std::uint64_t> bytes{ 0 };
+        std::atomic<std::uint64_t> violations{ 0 };
+    };
+
+    constexpr std::size_t maxZones = 64;
+    std::array<ZoneStats, maxZones> zones;
+    std::atomic<std::size_t> zoneCount{ 0 };
+    std::mutex zoneMutex; // Only taken when a zone name is seen for the first time
+
+    struct FrameTotals {
+        std::uint64_t frames = 0;
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t worstAllocations = 0;
+    };
+
+    FrameTotals frameTotals;
+    AllocationCounts frameStart;
+
+    ZoneStats* findZone(const char* name, bool zeroAllocation) {
+        std::size_t count = zoneCount.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (zones[i].name == name) return &zones[i];
+        }
+        std::scoped_lock lock(zoneMutex);
+        count = zoneCount.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (zones[i].name == name) return &zones[i];
+        }
+        if (count == maxZones) {
+            return nullptr;
+        }
+        zones[count].name = name;
+        zones[count].zeroAllocation = zeroAllocation;
+        zoneCount.store(count + 1, std::memory_order_release);
+        return &zones[count];
+    }
+}
+
+void countAllocation(std::size_t size) {
+    ++threadCounters.allocations;
+    threadCounters.bytes += size;
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(size, std::memory_order_relaxed);
+    if (zeroAllocationDepth > 0 && assertionsEnabled.load(std::memory_order_relaxed)) {
+        // Leave the zone first so reporting cannot recurse
+        zeroAllocationDepth = 0;
+        std::fprintf(stderr, "Allocation of %zu bytes inside zero-allocation zone %s\n", size, zeroAllocationName);
+        std::abort();
+    }
+}
+
+void countFree() {
+    ++threadCounters.frees;
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocationCounts threadAllocationCounts() {
+    return { threadCounters.allocations, threadCounters.bytes, threadCounters.frees };
+}
+
+AllocationCounts processAllocationCounts() {
+    return { totalAllocations.load(std::memory_order_relaxed), totalBytes.load(std::memory_order_relaxed),
+        totalFrees.load(std::memory_order_relaxed) };
+}
+
+void recordAllocationZone(const char* name, const AllocationCounts& start, bool zeroAllocation) {
+    ZoneStats* zone = findZone(name, zeroAllocation);
+    if (!zone) return;
+    std::uint64_t allocations = threadCounters.allocations - start.allocations;
+    zone->entries.fetch_add(1, std::memory_order_relaxed);
+    zone->allocations.fetch_add(allocations, std::memory_order_relaxed);
+    zone->bytes.fetch_add(threadCounters.bytes - start.bytes, std::memory_order_relaxed);
+    if (zeroAllocation && allocations > 0) {
+        zone->violations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void enterZeroAllocationZone(const char* name) {
+    if (zeroAllocationDepth++ == 0) {
+        zeroAllocationName = name;
+    }
+}
+
+void leaveZeroAllocationZone() {
+    if (zeroAllocationDepth > 0) --zeroAllocationDepth;
+}
+
+void setAllocationAssertions(bool enabled) {
+    assertionsEnabled = enabled;
+}
+
+void markAllocationFrame() {
+    AllocationCounts now = processAllocationCounts();
+    std::uint64_t allocations = now.allocations - frameStart.allocations;
+    ++frameTotals.frames;
+    frameTotals.allocations += allocations;
+    frameTotals.bytes += now.bytes - frameStart.bytes;
+    if (allocations > frameTotals.worstAllocations) frameTotals.worstAllocations = allocations;
+    frameStart = now;
+}
+
+void reportAllocationStats(std::ostream& out) {
+    if (!allocationTrackingEnabled) {
+        out << "Allocation tracking is not compiled in (define ARKANOID_ALLOC_TRACKING)\n";
+        return;
+    }
+    double frames = static_cast<double>(frameTotals.frames > 0 ? frameTotals.frames : 1);
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(1)
+        << "Allocations over " << frameTotals.frames << " frames: " << frameTotals.allocations / frames
+        << " per frame (" << frameTotals.bytes / frames / 1024.0 << " KB), worst frame "
+        << frameTotals.worstAllocations << "\n";
+    std::size_t count = zoneCount.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+        ZoneStats& zone = zones[i];
+        std::uint64_t entries = zone.entries.exchange(0, std::memory_order_relaxed);
+        std::uint64_t allocations = zone.allocations.exchange(0, std::memory_order_relaxed);
+        std::uint64_t bytes = zone.bytes.exchange(0, std::memory_order_relaxed);
+        std::uint64_t violations = zone.violations.exchange(0, std::memory_order_relaxed);
+        if (entries == 0) continue;
+        out << "  " << std::left << std::setw(20) << zone.name << std::right
+            << allocations / frames << " per frame (" << bytes / frames / 1024.0 << " KB), "
+            << static_cast<double>(allocations) / entries << " per entry";
+        if (zone.zeroAllocation) {
+            out << ", " << violations << " of " << entries << " entries allocated";
+        }
+        out << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+    frameTotals = {};
+    // Start the next frame after the report, so its own allocations are not counted
+    frameStart = processAllocationCounts();
+}
@@ -0,0 +1,86 @@
+export module alloc_tracker;
+
+import <cstddef>;
+import <cstdint>;
+import <ostream>;
+
+// Heap allocation instrumentation. Builds with ARKANOID_ALLOC_TRACKING defined replace the
+// global operator new/delete (alloc_hooks.cpp) to count allocations per thread; in other
+// builds the zones below compile to nothing and the counters stay at zero.
+
+export constexpr bool allocationTrackingEnabled =
+#ifdef ARKANOID_ALLOC_TRACKING
+    true;
+#else
+    false;
+#endif
+
+export struct AllocationCounts {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t frees = 0;
+};
+
+// Called by the replacement operator new/delete only
+export void countAllocation(std::size_t size);
+export void countFree();
+
+// Totals for the calling thread since it started
+export AllocationCounts threadAllocationCounts();
+// Totals for the whole process
+export AllocationCounts processAllocationCounts();
+
+// Adds the allocations the calling thread made since start to the named zone's totals
+export void recordAllocationZone(const char* name, const AllocationCounts& start, bool zeroAllocation);
+export void enterZeroAllocationZone(const char* name);
+export void leaveZeroAllocationZone();
+// When enabled, an allocation inside a ZeroAllocationScope aborts with the zone name instead
+// of only being counted
+export void setAllocationAssertions(bool enabled);
+
+// Closes the current frame: process-wide allocations since the previous call count towards it
+export void markAllocationFrame();
+// Prints per-frame averages and per-zone totals since the previous report, then starts over
+export void reportAllocationStats(std::ostream& out);
+
+// Attributes the calling thread's allocations during the scope to a named zone.
+// Names must be string literals.
+export class AllocationZone {
+public:
+    explicit AllocationZone(const char* name)
+        : name(name) {
+        if constexpr (allocationTrackingEnabled) start = threadAllocationCounts();
+    }
+    ~AllocationZone() {
+        if constexpr (allocationTrackingEnabled) recordAllocationZone(name, start, false);
+    }
+    AllocationZone(const AllocationZone&) = delete;
+    AllocationZone& operator=(const AllocationZone&) = delete;
+private:
+    const char* name;
+    AllocationCounts start;
+};
+
+// Marks a region that must not touch the heap on the calling thread. Violations are counted
+// in the report, or abort immediately when assertions are enabled.
+export class ZeroAllocationScope {
+public:
+    explicit ZeroAllocationScope(const char* name)
+        : name(name) {
+        if constexpr (allocationTrackingEnabled) {
+            start = threadAllocationCounts();
+            enterZeroAllocationZone(name);
+        }
+    }
+    ~ZeroAllocationScope() {
+        if constexpr (allocationTrackingEnabled) {
+            leaveZeroAllocationZone();
+            recordAllocationZone(name, start, true);
+        }
+    }
+    ZeroAllocationScope(const ZeroAllocationScope&) = delete;
+    ZeroAllocationScope& operator=(const ZeroAllocationScope&) = delete;
+private:
+    const char* name;
+    AllocationCounts start;
+};
@@ -0,0 +1,219 @@
+module asset_pack;
+
+import <algorithm>;
+import <array>;
+import <cstring>;
+import <filesystem>;
+import <fstream>;
+import <iostream>;
+import <stdexcept>;
+import <unordered_map>;
+import <vector>;
+import trace;
+
+namespace {
+    constexpr std::array<char, 8> packMagic = { 'A', 'R', 'K', 'P', 'A', 'C', 'K', '1' };
+
+    struct PackEntry {
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+    };
+
+    // Filled once at startup before any other thread runs, read-only afterwards
+    std::vector<std::byte> packData;
+    std::unordered_map<std::string, PackEntry> packIndex;
+
+    template<typename T>
+    T readInteger(const std::vector<std::byte>& data, std::size_t& pos) {
+        if (pos + sizeof(T) > data.size()) {
+            throw std::runtime_error("Asset pack index is truncated");
+        }
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(std::to_integer<std::uint8_t>(data[pos + i])) << (8 * i);
+        }
+        pos += sizeof(T);
+        return value;
+    }
+
+    template<typename T>
+    void writeInteger(std::ofstream& file, T value) {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    // Save data lives under assets/ too but changes while the game runs, so a pack must never
+    // carry (and later shadow) it: the leaderboard with its .bak/.tmp copies, the per-level
+    // leaderboards, and any temporary or backup file left by a durable write
+    bool isSaveData(const std::filesystem::path& relativePath) {
+        std::string name = relativePath.generic_string();
+        return name.starts_with("highscores.txt") || name.starts_with("leaderboards/")
+            || name.ends_with(".tmp") || name.ends_with(".bak");
+    }
+
+    // Copies in chunks rather than with `pack << file.rdbuf()`, which sets failbit on the pack
+    // when the asset is empty
+    std::uint64_t copyFile(std::ifstream& file, std::ofstream& pack) {
+        std::array<char, 64 * 1024> buffer;
+        std::uint64_t copied = 0;
+        while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+            pack.write(buffer.data(), file.gcount());
+            copied += static_cast<std::uint64_t>(file.gcount());
+        }
+        return copied;
+    }
+}
+
+bool mountAssetPack(const std::string& packPath) {
+    TraceScope scope("MountAssetPack", "io");
+    std::ifstream file(packPath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<std::byte> data(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+        throw std::runtime_error("Failed to read asset pack: " + packPath);
+    }
+    if (data.size() < packMagic.size() || std::memcmp(data.data(), packMagic.data(), packMagic.size()) != 0) {
+        throw std::runtime_error("Not an asset pack: " + packPath);
+    }
+
+    std::unordered_map<std::string, PackEntry> index;
+    std::size_t pos = packMagic.size();
+    std::uint32_t count = readInteger<std::uint32_t>(data, pos);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint16_t nameLength = readInteger<std::uint16_t>(data, pos);
+        if (pos + nameLength > data.size()) {
+            throw std::runtime_error("Asset pack index is truncated");
+        }
+        std::string name(reinterpret_cast<const char*>(data.data() + pos), nameLength);
+        pos += nameLength;
+        PackEntry entry;
+        entry.offset = readInteger<std::uint64_t>(data, pos);
+        entry.size = readInteger<std::uint64_t>(data, pos);
+        std::uint8_t compression = readInteger<std::uint8_t>(data, pos);
+        if (compression != assetCompressionNone) {
+            throw std::runtime_error("Unsupported compression for packed asset: " + name);
+        }
+        if (entry.offset > data.size() || entry.size > data.size() - entry.offset) {
+            throw std::runtime_error("Packed asset out of range: " + name);
+        }
+        index[name] = entry;
+    }
+
+    packData = std::move(data);
+    packIndex = std::move(index);
+    std::cout << "Mounted asset pack " << packPath << " (" << packIndex.size() << " files)\n";
+    return true;
+}
+
+bool isAssetPackMounted() {
+    return !packIndex.empty();
+}
+
+int writeAssetPack(const std::string& directory, const std::string& packPath) {
+    std::vector<std::filesystem::path> files;
+    auto packTarget = std::filesystem::weakly_canonical(packPath);
+    for (const auto& item : std::filesystem::recursive_directory_iterator(directory)) {
+        if (!item.is_regular_file() || std::filesystem::weakly_canonical(item.path()) == packTarget) {
+            continue;
+        }
+        if (isSaveData(item.path().lexically_relative(directory))) {
+            std::cout << "Not packing save data: " << item.path().generic_string() << "\n";
+            continue;
+        }
+        files.push_back(item.path());
+    }
+    if (files.empty()) {
+        throw std::runtime_error("No files to pack in: " + directory);
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<std::string> names;
+    std::uint64_t indexSize = packMagic.size() + sizeof(std::uint32_t);
+    for (const auto& path : files) {
+        names.push_back(path.generic_string());
+        if (names.back().size() > UINT16_MAX) {
+            throw std::runtime_error("Asset path too long: " + names.back());
+        }
+        indexSize += sizeof(std::uint16_t) + names.back().size() + 2 * sizeof(std::uint64_t) + sizeof(std::uint8_t);
+    }
+
+    std::ofstream pack(packPath, std::ios::binary);
+    if (!pack.is_open()) {
+        throw std::runtime_error("Failed to open asset pack for writing: " + packPath);
+    }
+    pack.write(packMagic.data(), packMagic.size());
+    writeInteger<std::uint32_t>(pack, static_cast<std::uint32_t>(files.size()));
+    std::uint64_t offset = indexSize;
+    std::vector<std::uint64_t> sizes;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        std::uint64_t size = std::filesystem::file_size(files[i]);
+        sizes.push_back(size);
+        writeInteger<std::uint16_t>(pack, static_cast<std::uint16_t>(names[i].size()));
+        pack.write(names[i].data(), names[i].size());
+        writeInteger<std::uint64_t>(pack, offset);
+        writeInteger<std::uint64_t>(pack, size);
+        writeInteger<std::uint8_t>(pack, assetCompressionNone);
+        offset += size;
+    }
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        std::ifstream file(files[i], std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open asset: " + names[i]);
+        }
+        if (copyFile(file, pack) != sizes[i]) {
+            throw std::runtime_error("Asset changed while packing: " + names[i]);
+        }
+    }
+    if (!pack) {
+        throw std::runtime_error("Failed to write asset pack: " + packPath);
+    }
+    return static_cast<int>(files.size());
+}
+
+std::span<const std::byte> findAsset(const std::string& path) {
+    auto it = packIndex.find(path);
+    if (it == packIndex.end()) {
+        return {};
+    }
+    return { packData.data() + it->second.offset, static_cast<std::size_t>(it->second.size) };
+}
+
+bool assetExists(const std::string& path) {
+    return packIndex.contains(path) || std::filesystem::exists(path);
+}
+
+std::vector<std::string> listPackedAssets(const std::string& prefix) {
+    std::vector<std::string> names;
+    for (const auto& [name, entry] : packIndex) {
+        if (name.starts_with(prefix)) {
+            names.push_back(name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool loadTexture(sf::Texture& texture, const std::string& path) {
+    auto data = findAsset(path);
+    return data.empty() ? texture.loadFromFile(path) : texture.loadFromMemory(data.data(), data.size());
+}
+
+bool loadFont(sf::Font& font, const std::string& path) {
+    auto data = findAsset(path);
+    return data.empty() ? font.loadFromFile(path) : font.loadFromMemory(data.data(), data.size());
+}
+
+bool loadSoundBuffer(sf::SoundBuffer& buffer, const std::string& path) {
+    auto data = findAsset(path);
+    return data.empty() ? buffer.loadFromFile(path) : buffer.loadFromMemory(data.data(), data.size());
+}
+
+// sf::Music streams from the pack buffer, which stays alive until the program exits
+bool openMusic(sf::Music& music, const std::string& path) {
+    auto data = findAsset(path);
+    return data.empty() ? music.openFromFile(path) : music.openFromMemory(data.data(), data.size());
+}
@@ -0,0 +1,34 @@
+export module asset_pack;
+
+import <SFML/Graphics.hpp>;
+import <SFML/Audio.hpp>;
+import <cstddef>;
+import <cstdint>;
+import <span>;
+import <string>;
+import <vector>;
+
+// Pack layout: "ARKPACK1", uint32 entry count, then per entry a uint16 name length, the
+// name, uint64 offset, uint64 size and a uint8 compression id, followed by the file data.
+// All integers are little-endian and offsets are relative to the start of the pack.
+export constexpr std::uint8_t assetCompressionNone = 0;
+
+// Reads the whole pack into memory with a single read. Returns false if the file is missing.
+export bool mountAssetPack(const std::string& packPath);
+export bool isAssetPackMounted();
+
+// Packs every regular file under directory; entries are named like the loose paths
+// ("assets/ball.png"). Returns the number of packed files.
+export int writeAssetPack(const std::string& directory, const std::string& packPath);
+
+// Contents of a packed file, or an empty span if it is not in the mounted pack
+export std::span<const std::byte> findAsset(const std::string& path);
+export bool assetExists(const std::string& path);
+// Names of the packed files that start with prefix, sorted
+export std::vector<std::string> listPackedAssets(const std::string& prefix);
+
+// Load from the mounted pack when it has the file, otherwise from the loose file
+export bool loadTexture(sf::Texture& texture, const std::string& path);
+export bool loadFont(sf::Font& font, const std::string& path);
+export bool loadSoundBuffer(sf::SoundBuffer& buffer, const std::string& path);
+export bool openMusic(sf::Music& music, const std::string& path);
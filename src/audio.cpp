@@ -1,18 +1,20 @@
 module audio;
 
+import asset_pack;
+import trace;
 import <stdexcept>;
 
 AudioManager::AudioManager() {
-    if (!backgroundMusic.openFromFile("assets/background.wav")) {
+    if (!openMusic(backgroundMusic, "assets/background.wav")) {
         throw std::runtime_error("Failed to load background music: assets/background.wav");
     }
     backgroundMusic.setLoop(true);
     backgroundMusic.setVolume(50.0f);
 
-    if (!hitBuffer.loadFromFile("assets/hit.wav")) {
+    if (!loadSoundBuffer(hitBuffer, "assets/hit.wav")) {
         throw std::runtime_error("Failed to load hit sound: assets/hit.wav");
     }
-    if (!destroyBuffer.loadFromFile("assets/destroy.wav")) {
+    if (!loadSoundBuffer(destroyBuffer, "assets/destroy.wav")) {
         throw std::runtime_error("Failed to load destroy sound: assets/destroy.wav");
     }
 
@@ -21,19 +23,23 @@ AudioManager::AudioManager() {
 }
 
 void AudioManager::playBackgroundMusic() {
+    TraceScope scope("PlayBackgroundMusic", "audio");
     if (backgroundMusic.getStatus() != sf::Music::Playing) {
         backgroundMusic.play();
     }
 }
 
 void AudioManager::stopBackgroundMusic() {
+    TraceScope scope("StopBackgroundMusic", "audio");
     backgroundMusic.stop();
 }
 
 void AudioManager::playHitSound() {
+    TraceScope scope("PlayHitSound", "audio");
     hitSound.play();
 }
 
 void AudioManager::playDestroySound() {
+    TraceScope scope("PlayDestroySound", "audio");
     destroySound.play();
 }
\ No newline at end of file
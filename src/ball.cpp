@@ -1,15 +1,14 @@
 module ball;
 
+import texture_cache;
 import <iostream>;
 import <cmath>;
 import <stdexcept>;
 
 Ball::Ball(float x, float y, float initialSpeed, std::string texturePath)
-    : speed(initialSpeed) {
-    if (!texture.loadFromFile(texturePath)) {
-        throw std::runtime_error("Failed to load texture: assets/ball.png");
-    }
-    sprite.setTexture(texture);
+    : speed(initialSpeed), bonusBall(texturePath != "assets/ball.png") {
+    // Shared so that thousands of balls do not each load their own copy
+    sprite.setTexture(getSharedTexture(texturePath));
     sprite.setPosition(x, y);
     sf::FloatRect spriteBounds = sprite.getLocalBounds();
     sprite.setScale(24.0f / spriteBounds.width, 24.0f / spriteBounds.height);
@@ -19,6 +18,9 @@ Ball::Ball(float x, float y, float initialSpeed, std::string texturePath)
 }
 
 void Ball::update(float deltaTime) {
+    if (outOfBounds) {
+        return;
+    }
     sf::Vector2f nextPos = sprite.getPosition() + velocity * deltaTime;
 
     // Sprawdź kolizję z bokami
@@ -55,6 +57,10 @@ bool Ball::isOutOfBounds() const {
     return outOfBounds;
 }
 
+bool Ball::isCollidable() const {
+    return !outOfBounds;
+}
+
 void Ball::reset(float x, float y) {
     sprite.setPosition(x, y);
     velocity = { 300.0f, -300.0f };
@@ -62,7 +68,16 @@ void Ball::reset(float x, float y) {
     outOfBounds = false;
 }
 
-void Ball::bounceFromPaddle(const Paddle& paddle, AudioManager& audioManager) {
+void Ball::respawn(float x, float y, float newSpeed) {
+    speed = newSpeed;
+    reset(x, y);
+}
+
+void Ball::park() {
+    outOfBounds = true;
+}
+
+bool Ball::bounceFromPaddle(const Paddle& paddle) {
     if (getBounds().intersects(paddle.getBounds())) {
         // Odbij pionowo
         velocity.y = -std::abs(velocity.y);
@@ -73,15 +88,16 @@ void Ball::bounceFromPaddle(const Paddle& paddle, AudioManager& audioManager) {
         velocity.x = (hitRatio - 0.5f) * speed * 1.5f;
 
         normalizeVelocity();
-        audioManager.playHitSound();
 
         // Przesuń piłkę ponad paletkę (zapobiega "klejeniu")
         sprite.setPosition(sprite.getPosition().x, paddle.getBounds().top - getBounds().height / 2 - 0.5);
+        return true;
     }
+    return false;
 }
 
 
-void Ball::bounceFromBlock(AudioManager& audioManager, sf::FloatRect blockBounds, bool isIndestructible) {
+void Ball::bounceFromBlock(sf::FloatRect blockBounds, bool isIndestructible) {
     float dx = (getBounds().left + getBounds().width / 2) - (blockBounds.left + blockBounds.width / 2);
     float dy = (getBounds().top + getBounds().height / 2) - (blockBounds.top + blockBounds.height / 2);
 
@@ -93,8 +109,6 @@ void Ball::bounceFromBlock(AudioManager& audioManager, sf::FloatRect blockBounds
     }
 
     normalizeVelocity();
-    audioManager.playHitSound();
-    std::cout << "Ball bounced: dx=" << dx << ", dy=" << dy << ", velocity=(" << velocity.x << ", " << velocity.y << ")\n";
 }
 
 void Ball::setVelocity(const sf::Vector2f& newVelocity) {
@@ -111,6 +125,14 @@ float Ball::getSpeed() const {
     return speed;
 }
 
+sf::Vector2f Ball::getPosition() const {
+    return sprite.getPosition();
+}
+
+bool Ball::isBonusBall() const {
+    return bonusBall;
+}
+
 void Ball::normalizeVelocity() {
     float currentSpeed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
     if (currentSpeed > 0) {
@@ -3,7 +3,6 @@ export module ball;
 import <SFML/Graphics.hpp>;
 import game_object;
 import paddle;
-import audio;
 
 export class Ball : public GameObject {
 public:
@@ -12,18 +11,25 @@ public:
     void draw(sf::RenderWindow& window) override;
     sf::FloatRect getBounds() const override;
     bool isOutOfBounds() const;
+    bool isCollidable() const override;
     void reset(float x, float y);
-    void bounceFromPaddle(const Paddle& paddle, AudioManager& audioManager);
-    void bounceFromBlock(AudioManager& audioManager, sf::FloatRect blockBounds, bool isIndestructible);
+    void respawn(float x, float y, float newSpeed);
+    // Takes the ball out of play until it is reset, e.g. while it waits in a pool
+    void park();
+    // Returns true if the ball touched the paddle and was bounced
+    bool bounceFromPaddle(const Paddle& paddle);
+    void bounceFromBlock(sf::FloatRect blockBounds, bool isIndestructible);
     void setVelocity(const sf::Vector2f& newVelocity);
     void increaseSpeed(float factor);
     float getSpeed() const;
+    sf::Vector2f getPosition() const;
+    bool isBonusBall() const;
 private:
     sf::Sprite sprite;
-    sf::Texture texture;
     sf::Vector2f velocity{ 300.0f, -300.0f };
     float speed;
     bool outOfBounds = false;
+    bool bonusBall = false;
 
     void normalizeVelocity();
 };
\ No newline at end of file
@@ -0,0 +1,102 @@
+module ball_benchmark;
+
+import <chrono>;
+import <cstdint>;
+import <cstring>;
+import <iomanip>;
+import <iostream>;
+import <vector>;
+import ball;
+import config;
+import collision_system;
+import gameplay_events;
+import gameplay_systems;
+import game_object_manager;
+import worker_pool;
+import random_service;
+
+namespace {
+    constexpr int benchmarkTicks = 360;
+    constexpr float tickSeconds = 1.0f / 120.0f;
+
+    struct BenchmarkResult {
+        double millisecondsPerTick = 0.0;
+        std::uint64_t checksum = 0;
+    };
+
+    // FNV-1a over score and raw ball positions; any divergence between runs changes it
+    std::uint64_t worldChecksum(GameObjectManager& manager) {
+        std::uint64_t hash = 1469598103934665603ull;
+        auto mix = [&hash](const void* data, size_t size) {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+        };
+        int score = manager.getScore();
+        mix(&score, sizeof(score));
+        for (auto ball : manager.getBalls()) {
+            sf::Vector2f position = ball->getPosition();
+            mix(&position, sizeof(position));
+        }
+        return hash;
+    }
+
+    BenchmarkResult runScene(AudioManager& audioManager, const LevelConfig& level, int ballCount, unsigned threads, std::uint64_t seed) {
+        // Creation logging would dominate the measurement
+        std::cout.setstate(std::ios_base::badbit);
+        WorkerPool pool(threads - 1);
+        GameObjectManager manager;
+        manager.setWorkerPool(&pool);
+        manager.reset(level.paddleWidth, level.ballSpeed, level.layout);
+        manager.spawnStressBalls(ballCount, level.ballSpeed);
+        // Every run starts from the same seed, so bonus drops match across thread counts
+        RandomService random(seed);
+        CollisionSystem collisionSystem(&pool);
+        GameplaySystems gameplaySystems(audioManager, random.stream(RandomStream::Gameplay));
+        GameplayEventQueue events;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < benchmarkTicks; ++tick) {
+            manager.update(tickSeconds);
+            events.clear();
+            collisionSystem.checkCollisions(manager, events);
+            gameplaySystems.process(events, manager);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        BenchmarkResult result;
+        result.millisecondsPerTick = std::chrono::duration<double, std::milli>(elapsed).count() / benchmarkTicks;
+        result.checksum = worldChecksum(manager);
+        std::cout.clear();
+        return result;
+    }
+}
+
+int runBallBenchmark(AudioManager& audioManager, const LevelConfig& level, int ballCount, unsigned maxThreads, std::uint64_t seed) {
+    if (maxThreads == 0) {
+        maxThreads = 1;
+    }
+
+    std::cout << "Ball physics benchmark: " << ballCount << " balls, " << benchmarkTicks << " ticks\n";
+    std::cout << "threads  ms/tick  speedup  checksum\n";
+    double baseline = 0.0;
+    std::uint64_t expectedChecksum = 0;
+    bool deterministic = true;
+    for (unsigned threads = 1; threads <= maxThreads; ++threads) {
+        BenchmarkResult result = runScene(audioManager, level, ballCount, threads, seed);
+        if (threads == 1) {
+            baseline = result.millisecondsPerTick;
+            expectedChecksum = result.checksum;
+        }
+        else if (result.checksum != expectedChecksum) {
+            deterministic = false;
+        }
+        std::cout << std::setw(7) << threads << "  "
+            << std::fixed << std::setprecision(3) << std::setw(7) << result.millisecondsPerTick << "  "
+            << std::setprecision(2) << std::setw(7) << baseline / result.millisecondsPerTick << "  "
+            << std::hex << result.checksum << std::dec << "\n";
+    }
+    std::cout << (deterministic ? "Results identical for every thread count\n" : "ERROR: results differ between thread counts\n");
+    return deterministic ? 0 : 1;
+}
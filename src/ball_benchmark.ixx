@@ -0,0 +1,9 @@
+export module ball_benchmark;
+
+import audio;
+import config;
+import <cstdint>;
+
+// Headless multiball scaling run: steps the same scene with 1..maxThreads threads and checks
+// that every thread count ends in exactly the same world state. The scene uses level's layout.
+export int runBallBenchmark(AudioManager& audioManager, const LevelConfig& level, int ballCount, unsigned maxThreads, std::uint64_t seed);
@@ -1,13 +1,16 @@
 module block;
 
 import <iostream>;
+import <algorithm>;
 
 Block::Block(float x, float y, float width, float height, sf::Color color) {
     shape.setSize({ width, height });
     shape.setFillColor(color);
-    shape.setOutlineThickness(2.0f);
+    // Thin outline on the tiny blocks of scaled-down layouts, otherwise it would cover the fill
+    shape.setOutlineThickness(std::min(2.0f, std::min(width, height) / 6.0f));
     shape.setOutlineColor(sf::Color::Black);
     shape.setPosition(x, y);
+    bounds = shape.getGlobalBounds();
 }
 
 void Block::update(float deltaTime) {}
@@ -17,15 +20,45 @@ void Block::draw(sf::RenderWindow& window) {
 }
 
 sf::FloatRect Block::getBounds() const {
-    return shape.getGlobalBounds();
+    return bounds;
 }
 
 bool Block::isDestroyed() const {
     return destroyed;
 }
 
-NormalBlock::NormalBlock(float x, float y, sf::Color color)
-    : Block(x, y, 50.0f, 20.0f, color), hitsRemaining(1) {
+sf::Color Block::getColor() const {
+    return shape.getFillColor();
+}
+
+float Block::getOutlineThickness() const {
+    return shape.getOutlineThickness();
+}
+
+void Block::moveTo(float x, float y) {
+    shape.setPosition(x, y);
+    bounds = shape.getGlobalBounds();
+}
+
+void Block::moveBy(float dy) {
+    shape.move(0.0f, dy);
+    bounds.top += dy;
+}
+
+void Block::setColor(sf::Color color) {
+    shape.setFillColor(color);
+}
+
+void Block::retire() {
+    destroyed = true;
+}
+
+void Block::revive(int hitPoints) {
+    destroyed = false;
+}
+
+NormalBlock::NormalBlock(float x, float y, sf::Color color, float width, float height, int hitPoints)
+    : Block(x, y, width, height, color), hitsRemaining(hitPoints) {
     std::cout << "NormalBlock created at (" << x << ", " << y << ")\n";
 }
 
@@ -38,8 +71,17 @@ bool NormalBlock::hit() {
     return false;
 }
 
-IndestructibleBlock::IndestructibleBlock(float x, float y)
-    : Block(x, y, 50.0f, 20.0f, sf::Color(100, 100, 100)) {
+int NormalBlock::getHitsRemaining() const {
+    return destroyed ? 0 : hitsRemaining;
+}
+
+void NormalBlock::revive(int hitPoints) {
+    destroyed = false;
+    hitsRemaining = hitPoints;
+}
+
+IndestructibleBlock::IndestructibleBlock(float x, float y, float width, float height)
+    : Block(x, y, width, height, sf::Color(100, 100, 100)) {
     std::cout << "IndestructibleBlock created at (" << x << ", " << y << ")\n";
 }
 
@@ -48,8 +90,8 @@ bool IndestructibleBlock::hit() {
     return false;
 }
 
-BonusBlock::BonusBlock(float x, float y)
-    : Block(x, y, 50.0f, 20.0f, sf::Color::Yellow) {
+BonusBlock::BonusBlock(float x, float y, float width, float height)
+    : Block(x, y, width, height, sf::Color::Yellow) {
     std::cout << "BonusBlock created at (" << x << ", " << y << ")\n";
 }
 
@@ -10,30 +10,44 @@ public:
     void draw(sf::RenderWindow& window) override;
     sf::FloatRect getBounds() const override;
     bool isDestroyed() const override;
+    sf::Color getColor() const;
+    float getOutlineThickness() const;
     virtual bool hit() = 0;
     virtual bool isBonusBlock() const { return false; }
+    // Hits left before the block breaks; 0 once destroyed
+    virtual int getHitsRemaining() const { return destroyed ? 0 : 1; }
+
+    // Endless mode reuses blocks instead of creating new ones
+    void moveTo(float x, float y);
+    void moveBy(float dy);
+    void setColor(sf::Color color);
+    void retire();
+    virtual void revive(int hitPoints);
 protected:
     sf::RectangleShape shape;
+    sf::FloatRect bounds; // Cached so ball queries on worker threads never touch the shape
     bool destroyed = false;
 };
 
 export class NormalBlock : public Block {
 public:
-    NormalBlock(float x, float y, sf::Color color = sf::Color::Green);
+    NormalBlock(float x, float y, sf::Color color = sf::Color::Green, float width = 50.0f, float height = 20.0f, int hitPoints = 1);
     bool hit() override;
+    int getHitsRemaining() const override;
+    void revive(int hitPoints) override;
 private:
     int hitsRemaining;
 };
 
 export class IndestructibleBlock : public Block {
 public:
-    IndestructibleBlock(float x, float y);
+    IndestructibleBlock(float x, float y, float width = 50.0f, float height = 20.0f);
     bool hit() override;
 };
 
 export class BonusBlock : public Block {
 public:
-    BonusBlock(float x, float y);
+    BonusBlock(float x, float y, float width = 50.0f, float height = 20.0f);
     bool hit() override;
     bool isBonusBlock() const override;
 };
\ No newline at end of file
@@ -4,9 +4,16 @@ import <iostream>;
 
 Bonus::Bonus(float x, float y, BonusType bonusType) : type(bonusType) {
     shape.setSize({20.0f, 20.0f});
-    shape.setPosition(x, y);
     shape.setOutlineThickness(2.0f);
     shape.setOutlineColor(sf::Color::Black);
+    respawn(x, y, bonusType);
+    std::cout << "Bonus created at (" << x << ", " << y << ") type: " << static_cast<int>(type) << "\n";
+}
+
+void Bonus::respawn(float x, float y, BonusType bonusType) {
+    type = bonusType;
+    collected = false;
+    shape.setPosition(x, y);
     switch (type) {
     case BonusType::ExtendPaddle:
         shape.setFillColor(sf::Color::Cyan);
@@ -18,7 +25,6 @@ Bonus::Bonus(float x, float y, BonusType bonusType) : type(bonusType) {
         shape.setFillColor(sf::Color::Red);
         break;
     }
-    std::cout << "Bonus created at (" << x << ", " << y << ") type: " << static_cast<int>(type) << "\n";
 }
 
 void Bonus::update(float deltaTime) {
@@ -48,6 +54,10 @@ BonusType Bonus::getType() const {
     return type;
 }
 
+sf::Color Bonus::getColor() const {
+    return shape.getFillColor();
+}
+
 void Bonus::collect() {
     collected = true;
 }
\ No newline at end of file
@@ -17,7 +17,10 @@ public:
     sf::FloatRect getBounds() const override;
     bool isDestroyed() const override;
     BonusType getType() const;
+    sf::Color getColor() const;
     void collect();
+    // Reuses a collected bonus for a new drop
+    void respawn(float x, float y, BonusType bonusType);
 private:
     sf::RectangleShape shape;
     BonusType type;
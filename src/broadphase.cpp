@@ -0,0 +1,67 @@
+module broadphase;
+
+import <algorithm>;
+
+void SweepAndPrune::add(GameObject* object, std::uint32_t layer, std::uint32_t mask) {
+    // New objects go to the end; the next update() moves them into place
+    proxies.push_back({ object, layer, mask, object->getBounds(), object->isCollidable() });
+}
+
+void SweepAndPrune::remove(const GameObject* object) {
+    std::erase_if(proxies, [object](const Proxy& proxy) { return proxy.object == object; });
+}
+
+void SweepAndPrune::reserve(size_t objectCount) {
+    proxies.reserve(objectCount);
+    pairs.reserve(objectCount);
+}
+
+void SweepAndPrune::clear() {
+    proxies.clear();
+    pairs.clear();
+}
+
+void SweepAndPrune::update() {
+    std::erase_if(proxies, [](const Proxy& proxy) { return proxy.object->isDestroyed(); });
+    for (auto& proxy : proxies) {
+        proxy.bounds = proxy.object->getBounds();
+        proxy.collidable = proxy.object->isCollidable();
+    }
+
+    // Insertion sort: close to O(n) because objects move only a little per frame
+    for (size_t i = 1; i < proxies.size(); ++i) {
+        Proxy current = proxies[i];
+        size_t j = i;
+        while (j > 0 && proxies[j - 1].bounds.left > current.bounds.left) {
+            proxies[j] = proxies[j - 1];
+            --j;
+        }
+        proxies[j] = current;
+    }
+
+    pairs.clear();
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        const Proxy& a = proxies[i];
+        if (!a.collidable) continue;
+        float maxX = a.bounds.left + a.bounds.width;
+        for (size_t j = i + 1; j < proxies.size() && proxies[j].bounds.left <= maxX; ++j) {
+            const Proxy& b = proxies[j];
+            if (!b.collidable || !(a.mask & b.layer) || !(b.mask & a.layer)) continue;
+            if (!a.bounds.intersects(b.bounds)) continue;
+            if (a.layer <= b.layer) {
+                pairs.push_back({ a.object, b.object, a.layer, b.layer });
+            }
+            else {
+                pairs.push_back({ b.object, a.object, b.layer, a.layer });
+            }
+        }
+    }
+}
+
+const std::vector<BroadphasePair>& SweepAndPrune::getPairs() const {
+    return pairs;
+}
+
+size_t SweepAndPrune::proxyCount() const {
+    return proxies.size();
+}
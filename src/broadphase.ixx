@@ -0,0 +1,57 @@
+export module broadphase;
+
+import <SFML/Graphics.hpp>;
+import <cstdint>;
+import <vector>;
+import game_object;
+
+export namespace CollisionLayer {
+    constexpr std::uint32_t Paddle = 1u << 0;
+    constexpr std::uint32_t Ball = 1u << 1;
+    constexpr std::uint32_t Bonus = 1u << 2;
+}
+
+export struct BroadphasePair {
+    GameObject* first;          // Always the object on the lower layer bit
+    GameObject* second;
+    std::uint32_t firstLayer;
+    std::uint32_t secondLayer;
+};
+
+// Sort-and-sweep along x for moving objects. The proxy list stays sorted between frames,
+// so the per-frame re-sort is an insertion sort over almost ordered data.
+export class SweepAndPrune {
+public:
+    // mask says which layers this object wants to be paired with; a pair is only reported
+    // when both sides accept each other
+    void add(GameObject* object, std::uint32_t layer, std::uint32_t mask);
+    void remove(const GameObject* object);
+    void clear();
+    // Sizes the proxy and pair buffers up front so update() does not grow them mid-level
+    void reserve(size_t objectCount);
+    void update();
+    const std::vector<BroadphasePair>& getPairs() const;
+    size_t proxyCount() const;
+
+    template<typename Callback>
+    void forEachPair(std::uint32_t layerA, std::uint32_t layerB, Callback&& callback) const {
+        for (const auto& pair : pairs) {
+            if (pair.firstLayer == layerA && pair.secondLayer == layerB) {
+                callback(*pair.first, *pair.second);
+            }
+            else if (pair.firstLayer == layerB && pair.secondLayer == layerA) {
+                callback(*pair.second, *pair.first);
+            }
+        }
+    }
+private:
+    struct Proxy {
+        GameObject* object;
+        std::uint32_t layer;
+        std::uint32_t mask;
+        sf::FloatRect bounds;
+        bool collidable;
+    };
+    std::vector<Proxy> proxies;
+    std::vector<BroadphasePair> pairs;
+};
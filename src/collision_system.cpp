@@ -1,95 +1,94 @@
 module collision_system;
 
-import <random>;
-import <iostream>;
+import <functional>;
 import <ranges>;
 import <limits>;
+import <algorithm>;
+import trace;
+import alloc_tracker;
 
-CollisionSystem::CollisionSystem(AudioManager& audio) : audioManager(audio) {}
+CollisionSystem::CollisionSystem(WorkerPool* pool) : workerPool(pool) {}
 
-void CollisionSystem::checkCollisions(GameObjectManager& manager) {
-    auto paddle = manager.getPaddle();
-    auto blocks = manager.getBlocks();
-    auto bonuses = manager.getBonuses();
-    auto balls = manager.getBalls();
+Block* CollisionSystem::findClosestBlock(const sf::FloatRect& ballBounds, const std::vector<Block*>& blocks) {
+    float minOverlap = std::numeric_limits<float>::max();
+    Block* closestBlock = nullptr;
+    for (auto block : blocks) {
+        if (block->isDestroyed()) continue;
+        sf::FloatRect blockBounds = block->getBounds();
+        if (ballBounds.intersects(blockBounds)) {
+            float overlapLeft = ballBounds.left + ballBounds.width - blockBounds.left;
+            float overlapRight = blockBounds.left + blockBounds.width - ballBounds.left;
+            float overlapTop = ballBounds.top + ballBounds.height - blockBounds.top;
+            float overlapBottom = blockBounds.top + blockBounds.height - ballBounds.top;
+            float overlap = std::min({ overlapLeft, overlapRight, overlapTop, overlapBottom });
+            if (overlap < minOverlap) {
+                minOverlap = overlap;
+                closestBlock = block;
+            }
+        }
+    }
+    return closestBlock;
+}
 
-    for (auto ball : balls) {
-        // Kolizja z paletką
-        ball->bounceFromPaddle(*paddle, audioManager);
+void CollisionSystem::checkCollisions(GameObjectManager& manager, GameplayEventQueue& events) {
+    TraceScope scope("Collisions", "sim");
+    AllocationZone allocationZone("Collisions");
+    auto paddle = manager.getPaddle();
+    const auto& blocks = manager.getBlocks();
+    const auto& balls = manager.getBalls();
+    auto& broadphase = manager.getBroadphase();
+    {
+        TraceScope broadphaseScope("Broadphase", "sim");
+        broadphase.update();
+    }
+    // A ball produces at most a paddle and a block event and a bonus at most one, so the
+    // queue never grows while the set of pooled objects stays the same
+    events.reserve(2 * broadphase.proxyCount());
 
-        // Kolizja z blokami
-        float minOverlap = std::numeric_limits<float>::max();
-        Block* closestBlock = nullptr;
-        sf::FloatRect ballBounds = ball->getBounds();
+    // Kolizja z paletką
+    broadphase.forEachPair(CollisionLayer::Paddle, CollisionLayer::Ball, [&](GameObject&, GameObject& ball) {
+        if (static_cast<Ball&>(ball).bounceFromPaddle(*paddle)) {
+            events.emit({ GameplayEventType::PaddleContact, BonusType::ExtendPaddle, false, ball.getBounds() });
+        }
+    });
 
-        for (auto block : blocks | std::ranges::views::filter([](GameObject* obj) { return !obj->isDestroyed(); })) {
-            if (ballBounds.intersects(block->getBounds())) {
-                auto blockPtr = dynamic_cast<Block*>(block);
-                if (blockPtr) {
-                    sf::FloatRect blockBounds = block->getBounds();
-                    float overlapLeft = ballBounds.left + ballBounds.width - blockBounds.left;
-                    float overlapRight = blockBounds.left + blockBounds.width - ballBounds.left;
-                    float overlapTop = ballBounds.top + ballBounds.height - blockBounds.top;
-                    float overlapBottom = blockBounds.top + blockBounds.height - ballBounds.top;
-                    float overlap = std::min({ overlapLeft, overlapRight, overlapTop, overlapBottom });
-                    if (overlap < minOverlap) {
-                        minOverlap = overlap;
-                        closestBlock = blockPtr;
-                    }
-                }
-            }
+    // Query phase: read-only, so every ball can search the blocks on its own thread
+    ballHits.assign(balls.size(), nullptr); // Keeps its capacity between ticks
+    auto queryBalls = [&](size_t begin, size_t end) {
+        TraceScope chunkScope("BlockQueryChunk", "sim");
+        for (size_t i = begin; i < end; ++i) {
+            ballHits[i] = findClosestBlock(balls[i]->getBounds(), blocks);
         }
+    };
+    if (workerPool) {
+        workerPool->parallelFor(balls.size(), std::ref(queryBalls));
+    }
+    else {
+        queryBalls(0, balls.size());
+    }
 
+    // Merge phase: applied in ball order, so the outcome does not depend on the thread count
+    for (size_t i = 0; i < balls.size(); ++i) {
+        auto ball = balls[i];
+        Block* closestBlock = ballHits[i];
+        // An earlier ball destroyed this block during the same tick: search again, here on the
+        // merging thread, so the ball hits the next block it overlaps as a serial pass would
+        if (closestBlock && closestBlock->isDestroyed()) {
+            closestBlock = findClosestBlock(ball->getBounds(), blocks);
+        }
         if (closestBlock) {
             bool isIndestructible = dynamic_cast<IndestructibleBlock*>(closestBlock) != nullptr;
-            ball->bounceFromBlock(audioManager, closestBlock->getBounds(), isIndestructible);
+            ball->bounceFromBlock(closestBlock->getBounds(), isIndestructible);
             bool destroyed = closestBlock->hit();
-            if (destroyed) {
-                audioManager.playDestroySound();
-                manager.addScore(100);
-                if (closestBlock->isBonusBlock()) {
-                    manager.addScore(500);
-                    std::random_device rd;
-                    std::mt19937 gen(rd());
-                    std::uniform_int_distribution<> dis(0, 2);
-                    BonusType type = static_cast<BonusType>(dis(gen));
-                    auto pos = closestBlock->getBounds();
-                    manager.add(std::make_unique<Bonus>(pos.left + pos.width / 2, pos.top + pos.height, type));
-                    std::cout << "Bonus spawned from BonusBlock\n";
-                }
-            }
-            else {
-                audioManager.playHitSound();
-            }
-            std::cout << "Collision with " << (isIndestructible ? "IndestructibleBlock" : "NormalBlock/BonusBlock")
-                << " at (" << closestBlock->getBounds().left << ", " << closestBlock->getBounds().top << ")\n";
+            events.emit({ destroyed ? GameplayEventType::BlockDestroyed : GameplayEventType::BlockHit, BonusType::ExtendPaddle,
+                destroyed && closestBlock->isBonusBlock(), closestBlock->getBounds() });
         }
     }
 
     // Kolizje z bonusami
-    for (auto bonus : bonuses) {
-        if (bonus->getBounds().intersects(paddle->getBounds())) {
-            bonus->collect();
-            switch (bonus->getType()) {
-            case BonusType::ExtendPaddle:
-                paddle->extend();
-                break;
-            case BonusType::MultiBall: {
-                auto balls = manager.getBalls();
-                if (!balls.empty()) {
-                    auto ball = balls[0];
-                    manager.add(std::make_unique<Ball>(
-                        ball->getBounds().left + 10.0f, ball->getBounds().top, ball->getSpeed(), "assets/bonus_ball.png")); // Usunięto ballColor
-                }
-                break;
-            }
-            case BonusType::SpeedUp:
-                for (auto ball : balls) {
-                    ball->increaseSpeed(1.2f);
-                }
-                break;
-            }
-            audioManager.playHitSound();
-        }
-    }
+    broadphase.forEachPair(CollisionLayer::Paddle, CollisionLayer::Bonus, [&](GameObject&, GameObject& object) {
+        auto& bonus = static_cast<Bonus&>(object);
+        bonus.collect();
+        events.emit({ GameplayEventType::BonusCollected, bonus.getType(), false, bonus.getBounds() });
+    });
 }
\ No newline at end of file
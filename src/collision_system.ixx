@@ -7,12 +7,19 @@ import ball;
 import block;
 import bonus;
 import game_object_manager;
-import audio;
+import gameplay_events;
+import worker_pool;
+import <vector>;
 
+// Detects contacts and applies the immediate physical response (bounces, block damage,
+// collecting bonuses); everything else is left to the consumers of the emitted events
 export class CollisionSystem {
 public:
-    CollisionSystem(AudioManager& audio);
-    void checkCollisions(GameObjectManager& manager);
+    explicit CollisionSystem(WorkerPool* pool = nullptr);
+    void checkCollisions(GameObjectManager& manager, GameplayEventQueue& events);
 private:
-    AudioManager& audioManager;
+    WorkerPool* workerPool;
+    std::vector<Block*> ballHits; // Closest block per ball, filled by the parallel query phase
+
+    static Block* findClosestBlock(const sf::FloatRect& ballBounds, const std::vector<Block*>& blocks);
 };
\ No newline at end of file
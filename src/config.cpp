@@ -1,65 +1,342 @@
 module config;
 
+import <algorithm>;
+import <charconv>;
 import <fstream>;
 import <stdexcept>;
-import <regex>;
-import <sstream>;
+import <string_view>;
+import <type_traits>;
+import asset_pack;
+import trace;
 
-LevelConfig loadLevelConfig(const std::string& filename) {
-    LevelConfig config{ 100.0f, 300.0f, {} };
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open level file: " + filename);
+namespace {
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+        return text;
     }
 
-    std::vector<std::string> layout;
-    std::string line;
-    std::regex paramPattern(R"(^(paddleWidth|ballSpeed):\s*(\d+(\.\d+)?)\s*$)");
-    std::regex blockPattern("^[0123]+$");
-    size_t rowLength = 0;
-    bool readingLayout = false;
+    bool isPlainCell(const LevelCell& cell) {
+        return cell.hitPoints == 1 && cell.variant == 0;
+    }
 
-    while (std::getline(file, line)) {
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
+    // Reads one line at a time and writes cells straight into the level's grid
+    class LevelParser {
+    public:
+        explicit LevelParser(const std::string& filename) : filename(filename) {}
 
-        if (line.empty()) continue;
+        void parseLine(std::string_view line) {
+            ++lineNumber;
+            line = trim(line);
+            if (line.empty()) return;
+            size_t colon = line.find(':');
+            if (colon != std::string_view::npos) {
+                if (rowsRead > 0) {
+                    fail("Parameters must be defined before level layout");
+                }
+                parseParameter(trim(line.substr(0, colon)), trim(line.substr(colon + 1)));
+                ++parametersRead;
+            }
+            else if (version == 1) {
+                parseRowV1(line);
+            }
+            else {
+                parseRowV2(line);
+            }
+        }
 
-        std::smatch match;
-        if (std::regex_match(line, match, paramPattern)) {
-            if (readingLayout) {
-                throw std::runtime_error("Parameters must be defined before level layout in: " + filename);
+        LevelConfig finish() {
+            if (rowsRead == 0) {
+                throw std::runtime_error("Level layout is empty in: " + filename);
             }
-            std::string paramName = match[1].str();
-            float value = std::stof(match[2].str());
-            if (paramName == "paddleWidth") {
-                config.paddleWidth = value;
+            if (version == 2 && rowsRead != config.layout.rows) {
+                throw std::runtime_error("Level has " + std::to_string(rowsRead) + " rows but its size says "
+                    + std::to_string(config.layout.rows) + ": " + filename);
             }
-            else if (paramName == "ballSpeed") {
-                config.ballSpeed = value;
+            config.layout.rows = rowsRead;
+            return std::move(config);
+        }
+
+    private:
+        const std::string& filename;
+        LevelConfig config;
+        int version = 1;
+        bool sizeGiven = false;
+        size_t lineNumber = 0;
+        size_t parametersRead = 0;
+        size_t rowsRead = 0;
+
+        [[noreturn]] void fail(std::string_view message) const {
+            throw std::runtime_error(std::string(message) + " (" + filename + ", line " + std::to_string(lineNumber) + ")");
+        }
+
+        template<typename T>
+        T parseNumber(std::string_view text, std::string_view what) const {
+            T value{};
+            auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            bool negative = false;
+            if constexpr (std::is_signed_v<T>) {
+                negative = value < 0;
             }
-            continue;
+            if (result.ec != std::errc() || result.ptr != text.data() + text.size() || negative) {
+                fail("Invalid " + std::string(what) + ": " + std::string(text));
+            }
+            return value;
         }
 
-        if (std::regex_match(line, blockPattern)) {
-            readingLayout = true;
-            if (rowLength == 0) {
-                rowLength = line.size();
+        void parseParameter(std::string_view name, std::string_view value) {
+            if (name == "version") {
+                if (parametersRead > 0) {
+                    fail("The version must come before the other parameters");
+                }
+                version = parseNumber<int>(value, "version");
+                if (version != 1 && version != 2) {
+                    fail("Unsupported level format version " + std::to_string(version));
+                }
             }
-            else if (line.size() != rowLength) {
-                throw std::runtime_error("Inconsistent row length in level file: " + line);
+            else if (name == "paddleWidth") {
+                config.paddleWidth = parseNumber<float>(value, "paddleWidth");
             }
-            layout.push_back(line);
-            continue;
+            else if (name == "ballSpeed") {
+                config.ballSpeed = parseNumber<float>(value, "ballSpeed");
+            }
+            else if (version == 2 && name == "name") {
+                config.name = value;
+            }
+            else if (version == 2 && name == "parScore") {
+                config.parScore = parseNumber<int>(value, "parScore");
+            }
+            else if (version == 2 && name == "difficulty") {
+                config.difficulty = parseNumber<int>(value, "difficulty");
+                if (config.difficulty < 1 || config.difficulty > 5) {
+                    fail("Difficulty must be between 1 and 5");
+                }
+            }
+            else if (version == 2 && name == "size") {
+                size_t x = value.find('x');
+                if (x == std::string_view::npos) {
+                    fail("Level size must look like ROWSxCOLUMNS");
+                }
+                config.layout.rows = parseNumber<size_t>(trim(value.substr(0, x)), "row count");
+                config.layout.columns = parseNumber<size_t>(trim(value.substr(x + 1)), "column count");
+                if (config.layout.rows == 0 || config.layout.columns == 0
+                    || config.layout.rows > 1000 || config.layout.columns > 1000) {
+                    fail("Level size must be between 1x1 and 1000x1000");
+                }
+                config.layout.cells.assign(config.layout.rows * config.layout.columns, LevelCell{});
+                sizeGiven = true;
+            }
+            else {
+                fail("Unknown level parameter: " + std::string(name));
+            }
+        }
+
+        CellType parseCellType(char c) const {
+            if (c < '0' || c > '3') {
+                fail(std::string("Invalid block type '") + c + "'");
+            }
+            return static_cast<CellType>(c - '0');
+        }
+
+        void parseRowV1(std::string_view line) {
+            if (rowsRead == 0) {
+                config.layout.columns = line.size();
+            }
+            else if (line.size() != config.layout.columns) {
+                fail("Inconsistent row length in level file: " + std::string(line));
+            }
+            for (char c : line) {
+                config.layout.cells.push_back({ parseCellType(c) });
+            }
+            ++rowsRead;
+        }
+
+        void parseRowV2(std::string_view line) {
+            if (!sizeGiven) {
+                fail("Version 2 levels need a size before the first row");
+            }
+            if (rowsRead == config.layout.rows) {
+                fail("More rows than the level size allows");
+            }
+            LevelCell* row = &config.layout.cells[rowsRead * config.layout.columns];
+            size_t column = 0;
+            auto put = [&](const LevelCell& cell, size_t count) {
+                if (count > config.layout.columns - column) {
+                    fail("Row is wider than the level size");
+                }
+                std::fill_n(row + column, count, cell);
+                column += count;
+            };
+            while (!line.empty()) {
+                size_t end = line.find_first_of(" \t");
+                std::string_view token = line.substr(0, end);
+                line = trim(line.substr(end == std::string_view::npos ? line.size() : end));
+
+                size_t count = 1;
+                size_t star = token.find('*');
+                if (star != std::string_view::npos) {
+                    count = parseNumber<size_t>(token.substr(0, star), "run length");
+                    token.remove_prefix(star + 1);
+                    if (count == 0 || token.empty()) {
+                        fail("Empty run in level row");
+                    }
+                }
+                if (token.find_first_of("hv") == std::string_view::npos) {
+                    if (star != std::string_view::npos && token.size() != 1) {
+                        fail("A run repeats a single cell: " + std::string(token));
+                    }
+                    // Bare digits: one plain cell per character
+                    for (char c : token) {
+                        put({ parseCellType(c) }, count);
+                    }
+                    continue;
+                }
+                put(parseCell(token), count);
+            }
+            if (column != config.layout.columns) {
+                fail("Row is narrower than the level size");
+            }
+            ++rowsRead;
+        }
+
+        // Single cell with modifiers, e.g. 1h3v2
+        LevelCell parseCell(std::string_view token) const {
+            LevelCell cell{ parseCellType(token.front()) };
+            token.remove_prefix(1);
+            while (!token.empty()) {
+                char modifier = token.front();
+                token.remove_prefix(1);
+                size_t digits = 0;
+                while (digits < token.size() && token[digits] >= '0' && token[digits] <= '9') ++digits;
+                int value = parseNumber<int>(token.substr(0, digits), "cell modifier");
+                token.remove_prefix(digits);
+                if (cell.type != CellType::Normal) {
+                    fail("Only normal blocks take hit points or variants");
+                }
+                if (modifier == 'h' && value >= 1 && value <= 255) {
+                    cell.hitPoints = static_cast<std::uint8_t>(value);
+                }
+                else if (modifier == 'v' && value < blockVariantCount) {
+                    cell.variant = static_cast<std::uint8_t>(value);
+                }
+                else {
+                    fail(std::string("Invalid cell modifier '") + modifier + std::to_string(value) + "'");
+                }
+            }
+            return cell;
         }
+    };
 
-        throw std::runtime_error("Invalid line in level file: " + line);
+    void appendCell(std::string& out, const LevelCell& cell) {
+        out += static_cast<char>('0' + static_cast<int>(cell.type));
+        if (cell.hitPoints != 1) {
+            out += 'h';
+            out += std::to_string(cell.hitPoints);
+        }
+        if (cell.variant != 0) {
+            out += 'v';
+            out += std::to_string(cell.variant);
+        }
     }
 
-    if (layout.empty()) {
-        throw std::runtime_error("Level layout is empty in: " + filename);
+    // Version 2 row: runs of four or more identical cells become "N*cell", short runs of
+    // plain cells are written together as digits
+    void encodeRow(const LevelCell* cells, size_t columns, std::string& out) {
+        out.clear();
+        bool inDigits = false;
+        for (size_t i = 0; i < columns;) {
+            size_t run = 1;
+            while (i + run < columns && cells[i + run] == cells[i]) ++run;
+            if (isPlainCell(cells[i]) && run < 4) {
+                if (!inDigits && !out.empty()) out += ' ';
+                out.append(run, static_cast<char>('0' + static_cast<int>(cells[i].type)));
+                inDigits = true;
+            }
+            else {
+                if (!out.empty()) out += ' ';
+                if (run > 1) {
+                    out += std::to_string(run);
+                    out += '*';
+                }
+                appendCell(out, cells[i]);
+                inDigits = false;
+            }
+            i += run;
+        }
     }
+}
 
-    config.levelLayout = layout;
-    return config;
-}
\ No newline at end of file
+LevelConfig loadLevelConfig(const std::string& filename) {
+    auto packed = findAsset(filename);
+    if (!packed.empty()) {
+        return parseLevelConfig(std::string_view(reinterpret_cast<const char*>(packed.data()), packed.size()), filename);
+    }
+    TraceScope scope("ParseLevelFile", "level");
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open level file: " + filename);
+    }
+
+    LevelParser parser(filename);
+    std::string line;
+    while (std::getline(file, line)) {
+        parser.parseLine(line);
+    }
+    return parser.finish();
+}
+
+LevelConfig parseLevelConfig(std::string_view text, const std::string& sourceName) {
+    TraceScope scope("ParseLevelText", "level");
+    LevelParser parser(sourceName);
+    while (!text.empty()) {
+        size_t newline = text.find('\n');
+        parser.parseLine(text.substr(0, newline));
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+    }
+    return parser.finish();
+}
+
+void saveLevelConfig(const LevelConfig& config, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open level file for writing: " + filename);
+    }
+    const LevelGrid& layout = config.layout;
+    bool plain = config.name.empty() && config.parScore == 0 && config.difficulty == 0;
+    for (const auto& cell : layout.cells) {
+        plain = plain && isPlainCell(cell);
+    }
+    std::vector<std::string> encodedRows(layout.rows);
+    size_t encodedSize = 0;
+    for (size_t row = 0; row < layout.rows; ++row) {
+        encodeRow(&layout.cells[row * layout.columns], layout.columns, encodedRows[row]);
+        encodedSize += encodedRows[row].size();
+    }
+    bool version2 = !plain || encodedSize * 4 <= layout.cells.size();
+
+    if (version2) {
+        file << "version: 2\n";
+        if (!config.name.empty()) {
+            file << "name: " << config.name << "\n";
+        }
+        if (config.parScore > 0) {
+            file << "parScore: " << config.parScore << "\n";
+        }
+        if (config.difficulty > 0) {
+            file << "difficulty: " << config.difficulty << "\n";
+        }
+        file << "size: " << layout.rows << "x" << layout.columns << "\n";
+    }
+    file << "paddleWidth: " << config.paddleWidth << "\n";
+    file << "ballSpeed: " << config.ballSpeed << "\n";
+    for (size_t row = 0; row < layout.rows; ++row) {
+        if (version2) {
+            file << encodedRows[row] << "\n";
+            continue;
+        }
+        for (size_t column = 0; column < layout.columns; ++column) {
+            file << static_cast<char>('0' + static_cast<int>(layout.at(row, column).type));
+        }
+        file << "\n";
+    }
+}
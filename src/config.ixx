@@ -1,12 +1,59 @@
 export module config;
 
+import <cstddef>;
+import <cstdint>;
 import <string>;
+import <string_view>;
 import <vector>;
 
+// Level files are text. Version 1 files (no version line) hold "name: value" parameters
+// followed by rows of cell digits: 0 empty, 1 normal, 2 indestructible, 3 bonus block.
+// Version 2 files start with "version: 2", may add name, parScore, difficulty (1 to 5) and size
+// ("ROWSxCOLUMNS", required before the first row) parameters, and write each row as space-separated tokens:
+//   1h3v2   one cell: type digit, then optional hit points and colour variant (normal blocks)
+//   40*0    a run of 40 identical cells; any single-cell token can be repeated this way
+//   1123    cells without modifiers may be written together, as in version 1
+export enum class CellType : std::uint8_t {
+    Empty = 0,
+    Normal = 1,
+    Indestructible = 2,
+    Bonus = 3
+};
+
+export constexpr int blockVariantCount = 4;
+
+export struct LevelCell {
+    CellType type = CellType::Empty;
+    std::uint8_t hitPoints = 1;
+    std::uint8_t variant = 0;
+
+    bool operator==(const LevelCell&) const = default;
+};
+
+// Row-major cell storage; the parser writes straight into it
+export struct LevelGrid {
+    std::size_t rows = 0;
+    std::size_t columns = 0;
+    std::vector<LevelCell> cells;
+
+    LevelCell& at(std::size_t row, std::size_t column) { return cells[row * columns + column]; }
+    const LevelCell& at(std::size_t row, std::size_t column) const { return cells[row * columns + column]; }
+    bool empty() const { return cells.empty(); }
+};
+
 export struct LevelConfig {
-    float paddleWidth;
-    float ballSpeed;
-    std::vector<std::string> levelLayout;
+    float paddleWidth = 100.0f;
+    float ballSpeed = 300.0f;
+    LevelGrid layout;
+    std::string name; // Version 2 metadata; empty and 0 when not given
+    int parScore = 0;
+    int difficulty = 0;
 };
 
-export LevelConfig loadLevelConfig(const std::string& filename);
\ No newline at end of file
+export LevelConfig loadLevelConfig(const std::string& filename);
+// Parses level text already in memory; sourceName only appears in error messages
+export LevelConfig parseLevelConfig(std::string_view text, const std::string& sourceName);
+// Writes version 1 when the level has no version 2 features and run-length encoding would
+// not make the layout at least four times smaller, so older builds can still read it
+export void saveLevelConfig(const LevelConfig& config, const std::string& filename);
+
@@ -0,0 +1,74 @@
+module;
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+module durable_file;
+
+import <cstdio>;
+import <filesystem>;
+import <stdexcept>;
+import trace;
+
+namespace {
+    // Writes everything and, if requested, flushes the OS cache to the device
+    void writeAndClose(std::FILE* file, const std::string& path, std::string_view contents, bool sync) {
+        bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+        ok = std::fflush(file) == 0 && ok;
+        if (ok && sync) {
+            TraceScope scope("SyncFile", "io");
+#ifdef _WIN32
+            ok = _commit(_fileno(file)) == 0;
+#else
+            ok = fsync(fileno(file)) == 0;
+#endif
+        }
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok) {
+            throw std::runtime_error("Failed to write file: " + path);
+        }
+    }
+}
+
+void writeFileAtomically(const std::string& path, std::string_view contents, bool sync) {
+    TraceScope scope("WriteFileAtomically", "io");
+    std::string temporaryPath = path + ".tmp";
+    std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Failed to open file for writing: " + temporaryPath);
+    }
+    writeAndClose(file, temporaryPath, contents, sync);
+
+    // The old version stays around as the backup until the next write replaces it
+    std::error_code error;
+    if (std::filesystem::exists(path, error)) {
+        std::filesystem::rename(path, path + ".bak", error);
+        if (error) {
+            throw std::runtime_error("Failed to back up " + path + ": " + error.message());
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        throw std::runtime_error("Failed to replace " + path + ": " + error.message());
+    }
+}
+
+void appendToFile(const std::string& path, std::string_view contents, bool sync) {
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        throw std::runtime_error("Failed to open file for appending: " + path);
+    }
+    writeAndClose(file, path, contents, sync);
+}
+
+std::uint32_t recordChecksum(std::string_view data) {
+    std::uint32_t hash = 2166136261u;
+    for (char c : data) {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,17 @@
+export module durable_file;
+
+import <cstdint>;
+import <string>;
+import <string_view>;
+
+// Crash-safe file updates. A file is never rewritten in place: the new contents go to
+// "path.tmp", which is renamed over the original once complete, and the previous version is
+// kept as "path.bak". With sync enabled the data reaches the disk before the rename, so after
+// a crash one of the three files always holds a complete version.
+export void writeFileAtomically(const std::string& path, std::string_view contents, bool sync);
+
+// Appends to path in a single write; with sync enabled it returns only once the data is on disk
+export void appendToFile(const std::string& path, std::string_view contents, bool sync);
+
+// FNV-1a, used to checksum individual records
+export std::uint32_t recordChecksum(std::string_view data);
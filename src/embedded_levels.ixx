@@ -0,0 +1,134 @@
+export module embedded_levels;
+
+import <array>;
+import <cstddef>;
+import <string_view>;
+
+export constexpr std::size_t maxEmbeddedRows = 64;
+export constexpr std::size_t maxEmbeddedColumns = 64;
+
+export struct EmbeddedLevel {
+    float paddleWidth = 100.0f;
+    float ballSpeed = 300.0f;
+    std::size_t rows = 0;
+    std::size_t columns = 0;
+    std::array<char, maxEmbeddedRows * maxEmbeddedColumns> cells{};
+
+    constexpr std::string_view row(std::size_t index) const {
+        return { cells.data() + index * columns, columns };
+    }
+};
+
+// Helpers have module linkage so the exported consteval parser may use them
+constexpr std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+constexpr bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Digits with an optional fraction, as version 1 level files write them
+constexpr float parseNumber(std::string_view text) {
+    text = trim(text);
+    if (text.empty() || !isDigit(text.front())) {
+        throw "Level parameter must be a non-negative number";
+    }
+    float value = 0.0f;
+    std::size_t i = 0;
+    for (; i < text.size() && isDigit(text[i]); ++i) {
+        value = value * 10.0f + (text[i] - '0');
+    }
+    if (i < text.size() && text[i] == '.') {
+        ++i;
+        if (i == text.size() || !isDigit(text[i])) {
+            throw "Level parameter has an empty fraction";
+        }
+        float scale = 0.1f;
+        for (; i < text.size() && isDigit(text[i]); ++i) {
+            value += (text[i] - '0') * scale;
+            scale /= 10.0f;
+        }
+    }
+    if (i != text.size()) {
+        throw "Unexpected characters after level parameter";
+    }
+    return value;
+}
+
+// Parses and validates a version 1 level (paddleWidth and ballSpeed, then rows of 0-3) at
+// compile time. Version 2 features (version, metadata, size, run-length rows, cell modifiers)
+// are rejected. Any error is a throw inside constant evaluation, so a broken embedded level
+// stops the build instead of failing at startup.
+export consteval EmbeddedLevel parseEmbeddedLevel(std::string_view source) {
+    EmbeddedLevel level;
+    bool readingLayout = false;
+    while (!source.empty()) {
+        std::size_t end = source.find('\n');
+        std::string_view line = trim(source.substr(0, end));
+        source.remove_prefix(end == std::string_view::npos ? source.size() : end + 1);
+        if (line.empty()) continue;
+
+        std::size_t colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            if (readingLayout) {
+                throw "Parameters must be defined before level layout";
+            }
+            std::string_view name = line.substr(0, colon);
+            if (name == "paddleWidth") {
+                level.paddleWidth = parseNumber(line.substr(colon + 1));
+            }
+            else if (name == "ballSpeed") {
+                level.ballSpeed = parseNumber(line.substr(colon + 1));
+            }
+            else {
+                throw "Unknown level parameter";
+            }
+            continue;
+        }
+
+        for (char c : line) {
+            if (c < '0' || c > '3') {
+                throw "Invalid block character in level layout";
+            }
+        }
+        readingLayout = true;
+        if (level.rows == 0) {
+            if (line.size() > maxEmbeddedColumns) {
+                throw "Level row is too long to embed";
+            }
+            level.columns = line.size();
+        }
+        else if (line.size() != level.columns) {
+            throw "Inconsistent row length in level layout";
+        }
+        if (level.rows == maxEmbeddedRows) {
+            throw "Level has too many rows to embed";
+        }
+        for (std::size_t i = 0; i < line.size(); ++i) {
+            level.cells[level.rows * level.columns + i] = line[i];
+        }
+        ++level.rows;
+    }
+    if (level.rows == 0) {
+        throw "Level layout is empty";
+    }
+    return level;
+}
+
+// Source text of every assets/levelN.txt in level order, regenerated before each build by
+// tools/embed_levels.ps1
+constexpr std::string_view embeddedLevelSources[] = {
+#include "embedded_level_sources.inc"
+};
+
+// Built-in campaign, parsed while compiling
+export constexpr auto embeddedLevels = []() consteval {
+    std::array<EmbeddedLevel, std::size(embeddedLevelSources)> levels;
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        levels[i] = parseEmbeddedLevel(embeddedLevelSources[i]);
+    }
+    return levels;
+}();
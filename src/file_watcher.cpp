@@ -0,0 +1,44 @@
+module file_watcher;
+
+import <system_error>;
+
+void FileWatcher::watch(const std::string& path, std::chrono::milliseconds interval) {
+    this->path = path;
+    this->interval = interval;
+    std::error_code error;
+    lastWriteTime = std::filesystem::last_write_time(path, error);
+    nextCheck = std::chrono::steady_clock::now() + interval;
+    watching = true;
+}
+
+void FileWatcher::stop() {
+    watching = false;
+}
+
+bool FileWatcher::isWatching() const {
+    return watching;
+}
+
+const std::string& FileWatcher::getPath() const {
+    return path;
+}
+
+bool FileWatcher::poll() {
+    if (!watching) {
+        return false;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < nextCheck) {
+        return false;
+    }
+    nextCheck = now + interval;
+
+    // Editors often replace the file while saving; a missing file is simply checked again later
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    if (error || writeTime == lastWriteTime) {
+        return false;
+    }
+    lastWriteTime = writeTime;
+    return true;
+}
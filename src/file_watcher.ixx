@@ -0,0 +1,23 @@
+export module file_watcher;
+
+import <chrono>;
+import <filesystem>;
+import <string>;
+
+// Polls a file's modification time at a fixed interval. Polling instead of OS change
+// notifications keeps this portable; one stat every few hundred milliseconds costs nothing.
+export class FileWatcher {
+public:
+    void watch(const std::string& path, std::chrono::milliseconds interval = std::chrono::milliseconds(250));
+    void stop();
+    bool isWatching() const;
+    const std::string& getPath() const;
+    // Returns true once for every change seen since the previous call
+    bool poll();
+private:
+    std::string path;
+    std::filesystem::file_time_type lastWriteTime{};
+    std::chrono::steady_clock::time_point nextCheck{};
+    std::chrono::milliseconds interval{ 250 };
+    bool watching = false;
+};
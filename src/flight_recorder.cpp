@@ -0,0 +1,366 @@
+module;
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+module flight_recorder;
+
+import <array>;
+import <atomic>;
+import <chrono>;
+import <csignal>;
+import <cstdint>;
+import <cstdio>;
+import <cstdlib>;
+import <exception>;
+import <iostream>;
+import <mutex>;
+
+namespace {
+    enum class RecordKind : std::uint8_t {
+        Frame,
+        Entities,
+        Collisions,
+        Transition,
+        Note
+    };
+
+    struct FlightRecord {
+        // 2 * index + 1 while record index is being written, 2 * index + 2 once it is complete
+        std::atomic<std::uint64_t> sequence{ 0 };
+        std::int64_t timeUs = 0;
+        std::uint64_t frame = 0;
+        RecordKind kind = RecordKind::Note;
+        const char* label = "";
+        const char* detail = "";
+        float values[4] = {};
+    };
+
+    constexpr std::size_t capacity = 4096;
+    std::array<FlightRecord, capacity> ring;
+    std::atomic<std::uint64_t> head{ 0 };
+    std::atomic<std::uint64_t> frameNumber{ 0 };
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // The log is opened up front so a crash only has to write to it. Once it grows past
+    // maxLogBytes the next hitch dump moves it to logPath.1, replacing the one before.
+    constexpr std::int64_t maxLogBytes = 4 * 1024 * 1024;
+    std::string logPath = "flight_recorder.log";
+    std::atomic<int> logFile{ -1 };
+    std::atomic<std::int64_t> logBytes{ 0 };
+    float hitchSeconds = 0.1f;
+    std::int64_t lastHitchDumpUs = -1000000;
+    std::mutex dumpMutex;
+
+    std::int64_t nowMicroseconds() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    void push(RecordKind kind, const char* label, const char* detail, float a, float b, float c, float d) {
+        std::uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+        FlightRecord& record = ring[index % capacity];
+        record.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        record.timeUs = nowMicroseconds();
+        record.frame = frameNumber.load(std::memory_order_relaxed);
+        record.kind = kind;
+        record.label = label;
+        record.detail = detail;
+        record.values[0] = a;
+        record.values[1] = b;
+        record.values[2] = c;
+        record.values[3] = d;
+        record.sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    // Copies record index out of the ring; false if it was overwritten or is still being written
+    bool readRecord(std::uint64_t index, FlightRecord& copy) {
+        const FlightRecord& record = ring[index % capacity];
+        if (record.sequence.load(std::memory_order_acquire) != 2 * index + 2) {
+            return false;
+        }
+        copy.timeUs = record.timeUs;
+        copy.frame = record.frame;
+        copy.kind = record.kind;
+        copy.label = record.label;
+        copy.detail = record.detail;
+        for (int i = 0; i < 4; ++i) {
+            copy.values[i] = record.values[i];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return record.sequence.load(std::memory_order_relaxed) == 2 * index + 2;
+    }
+
+    int openLog(const char* path) {
+#ifdef _WIN32
+        return _open(path, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        return open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+    }
+
+    void closeLog(int file) {
+#ifdef _WIN32
+        _close(file);
+#else
+        close(file);
+#endif
+    }
+
+    std::int64_t logSize(int file) {
+#ifdef _WIN32
+        return _lseeki64(file, 0, SEEK_END);
+#else
+        return lseek(file, 0, SEEK_END);
+#endif
+    }
+
+    void reopenLog() {
+        int previous = logFile.exchange(-1);
+        if (previous >= 0) {
+            closeLog(previous);
+        }
+        int file = openLog(logPath.c_str());
+        logBytes.store(file >= 0 ? logSize(file) : 0);
+        logFile.store(file);
+    }
+
+    // Not for signal handlers: renames and reopens the log
+    void rotateLogIfFull() {
+        if (logFile.load() >= 0 && logBytes.load() < maxLogBytes) {
+            return;
+        }
+        if (logFile.load() >= 0) {
+            int previous = logFile.exchange(-1);
+            closeLog(previous);
+            std::string rotatedPath = logPath + ".1";
+            std::remove(rotatedPath.c_str());
+            std::rename(logPath.c_str(), rotatedPath.c_str());
+        }
+        reopenLog();
+    }
+
+    // Formats into a fixed buffer and hands it to the raw file API: no locks, no heap and no
+    // stdio, so dumps are safe from a signal handler
+    class DumpWriter {
+    public:
+        explicit DumpWriter(int file) : file(file) {}
+        ~DumpWriter() { flush(); }
+
+        DumpWriter& text(const char* s) {
+            while (*s) put(*s++);
+            return *this;
+        }
+
+        DumpWriter& number(std::uint64_t value, int width = 0) {
+            char digits[24];
+            int count = 0;
+            do {
+                digits[count++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value > 0);
+            for (int i = count; i < width; ++i) put(' ');
+            while (count > 0) put(digits[--count]);
+            return *this;
+        }
+
+        DumpWriter& fixed(double value, int decimals, int width = 0) {
+            if (!(value > -1e15 && value < 1e15)) {
+                return text("?");
+            }
+            bool negative = value < 0;
+            std::uint64_t scale = 1;
+            for (int i = 0; i < decimals; ++i) scale *= 10;
+            std::uint64_t scaled = static_cast<std::uint64_t>((negative ? -value : value) * scale + 0.5);
+            std::uint64_t whole = scaled / scale;
+            int length = (negative ? 1 : 0) + digitCount(whole) + (decimals > 0 ? decimals + 1 : 0);
+            for (int i = length; i < width; ++i) put(' ');
+            if (negative) put('-');
+            number(whole);
+            if (decimals > 0) {
+                put('.');
+                zeroPadded(scaled % scale, decimals);
+            }
+            return *this;
+        }
+
+        void flush() {
+            const char* data = buffer;
+            while (used > 0 && file >= 0) {
+#ifdef _WIN32
+                int written = _write(file, data, static_cast<unsigned int>(used));
+#else
+                auto written = write(file, data, used);
+#endif
+                if (written <= 0) {
+                    break;
+                }
+                logBytes.fetch_add(written, std::memory_order_relaxed);
+                data += written;
+                used -= static_cast<std::size_t>(written);
+            }
+            used = 0;
+        }
+
+    private:
+        int file;
+        char buffer[4096];
+        std::size_t used = 0;
+
+        void put(char c) {
+            if (used == sizeof(buffer)) flush();
+            buffer[used++] = c;
+        }
+
+        // Zero-padded to exactly width digits
+        void zeroPadded(std::uint64_t value, int width) {
+            char digits[24];
+            for (int i = width - 1; i >= 0; --i) {
+                digits[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            for (int i = 0; i < width; ++i) put(digits[i]);
+        }
+
+        static int digitCount(std::uint64_t value) {
+            int count = 1;
+            while (value >= 10) {
+                value /= 10;
+                ++count;
+            }
+            return count;
+        }
+    };
+
+    void writeRecord(DumpWriter& out, const FlightRecord& record) {
+        out.fixed(record.timeUs / 1000.0, 3, 10).text(" ms  frame ").number(record.frame, 6).text("  ");
+        switch (record.kind) {
+        case RecordKind::Frame:
+            out.text("Frame       ").fixed(record.values[0], 3).text(" ms\n");
+            break;
+        case RecordKind::Entities:
+            out.text("Entities    balls ").fixed(record.values[0], 0).text(", bonuses ").fixed(record.values[1], 0)
+                .text(", blocks ").fixed(record.values[2], 0).text("\n");
+            break;
+        case RecordKind::Collisions:
+            out.text("Collisions  paddle ").fixed(record.values[0], 0).text(", block hits ").fixed(record.values[1], 0)
+                .text(", destroyed ").fixed(record.values[2], 0).text(", bonuses ").fixed(record.values[3], 0).text("\n");
+            break;
+        case RecordKind::Transition:
+            out.text("Transition  ").text(record.label).text(" ").text(record.detail).text("\n");
+            break;
+        case RecordKind::Note:
+            out.text("Note        ").text(record.label).text(" ").fixed(record.values[0], 3).text("\n");
+            break;
+        }
+    }
+
+    // Safe to call from a signal handler; records being written meanwhile are skipped
+    void writeDump(const char* reason, const char* detail) {
+        DumpWriter out(logFile.load());
+        std::uint64_t end = head.load(std::memory_order_acquire);
+        std::uint64_t begin = end > capacity ? end - capacity : 0;
+        out.text("=== Flight recorder dump: ").text(reason).text(detail[0] ? ": " : "").text(detail)
+            .text(" (at ").fixed(nowMicroseconds() / 1000.0, 3).text(" ms, ").number(end - begin).text(" records) ===\n");
+        FlightRecord record;
+        for (std::uint64_t i = begin; i < end; ++i) {
+            if (readRecord(i, record)) {
+                writeRecord(out, record);
+            }
+        }
+        out.text("\n");
+    }
+
+    void onTerminate() {
+        const char* what = "no active exception";
+        if (auto exception = std::current_exception()) {
+            try {
+                std::rethrow_exception(exception);
+            }
+            catch (const std::exception& e) {
+                what = e.what();
+            }
+            catch (...) {
+                what = "unknown exception";
+            }
+            writeDump("unhandled exception", what);
+        }
+        else {
+            writeDump("std::terminate", what);
+        }
+        std::cerr << "Fatal error (" << what << "), flight recorder written to " << logPath << "\n";
+        std::signal(SIGABRT, SIG_DFL); // Already dumped; do not dump again from the abort signal
+        std::abort();
+    }
+
+    void onFatalSignal(int signal) {
+        const char* name = signal == SIGSEGV ? "SIGSEGV" : signal == SIGFPE ? "SIGFPE" : signal == SIGILL ? "SIGILL" : "SIGABRT";
+        writeDump("fatal signal", name);
+        std::signal(signal, SIG_DFL);
+        std::raise(signal);
+    }
+}
+
+void configureFlightRecorder(const std::string& path, float hitchMilliseconds) {
+    {
+        std::scoped_lock lock(dumpMutex);
+        logPath = path;
+        reopenLog();
+    }
+    hitchSeconds = hitchMilliseconds / 1000.0f;
+    std::set_terminate(onTerminate);
+    for (int signal : { SIGSEGV, SIGFPE, SIGILL, SIGABRT }) {
+        std::signal(signal, onFatalSignal);
+    }
+}
+
+void recordFrame(float seconds) {
+    frameNumber.fetch_add(1, std::memory_order_relaxed);
+    push(RecordKind::Frame, "", "", seconds * 1000.0f, 0.0f, 0.0f, 0.0f);
+    if (hitchSeconds > 0.0f && seconds > hitchSeconds) {
+        // Writing the dump is itself a slow frame, so dumps are at most one per second
+        std::int64_t now = nowMicroseconds();
+        if (now - lastHitchDumpUs >= 1000000) {
+            lastHitchDumpUs = now;
+            char detail[32];
+            std::snprintf(detail, sizeof(detail), "%.1f ms frame", seconds * 1000.0f);
+            {
+                std::scoped_lock lock(dumpMutex);
+                rotateLogIfFull();
+                writeDump("hitch", detail);
+            }
+            std::cerr << "Hitch: " << detail << ", flight recorder written to " << logPath << "\n";
+        }
+    }
+}
+
+void recordEntityCounts(int balls, int bonuses, int blocks) {
+    push(RecordKind::Entities, "", "", static_cast<float>(balls), static_cast<float>(bonuses), static_cast<float>(blocks), 0.0f);
+}
+
+void recordCollisions(int paddleContacts, int blockHits, int blocksDestroyed, int bonusesCollected) {
+    push(RecordKind::Collisions, "", "", static_cast<float>(paddleContacts), static_cast<float>(blockHits),
+        static_cast<float>(blocksDestroyed), static_cast<float>(bonusesCollected));
+}
+
+void recordTransition(const char* what, const char* stateName) {
+    push(RecordKind::Transition, what, stateName, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void recordNote(const char* what, float value) {
+    push(RecordKind::Note, what, "", value, 0.0f, 0.0f, 0.0f);
+}
+
+void dumpFlightRecorder(const char* reason, const char* detail) {
+    if (head.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    std::scoped_lock lock(dumpMutex);
+    rotateLogIfFull();
+    writeDump(reason, detail);
+}
@@ -0,0 +1,22 @@
+export module flight_recorder;
+
+import <string>;
+
+// Always-on ring buffer of the last few thousand gameplay events (a few seconds of play).
+// Recording is a single atomic increment and a small copy, from any thread. The buffer is
+// appended to the log file on an unhandled exception, a fatal signal, or a frame slower than
+// the hitch threshold; a full log is moved aside to FILE.1. Labels must be string literals
+// or other static strings.
+
+// Installs the terminate and signal handlers. hitchMilliseconds <= 0 disables hitch dumps.
+export void configureFlightRecorder(const std::string& logPath, float hitchMilliseconds);
+
+export void recordFrame(float seconds);
+export void recordEntityCounts(int balls, int bonuses, int blocks);
+// One record per simulation tick that had any collisions
+export void recordCollisions(int paddleContacts, int blockHits, int blocksDestroyed, int bonusesCollected);
+export void recordTransition(const char* what, const char* stateName);
+export void recordNote(const char* what, float value);
+
+// Does nothing before the first record, when there is nothing worth keeping
+export void dumpFlightRecorder(const char* reason, const char* detail = "");
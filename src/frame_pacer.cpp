@@ -0,0 +1,211 @@
+module;
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+module frame_pacer;
+
+import <algorithm>;
+import <cmath>;
+import <iomanip>;
+import <iostream>;
+import <stdexcept>;
+import <thread>;
+import <vector>;
+import trace;
+
+PacingOptions parsePacingOptions(const std::string& text) {
+    PacingOptions options;
+    if (text == "uncapped") {
+        options.mode = PacingMode::Uncapped;
+    }
+    else if (text == "vsync") {
+        options.mode = PacingMode::VSync;
+    }
+    else {
+        options.mode = PacingMode::Target;
+        options.targetHz = std::stod(text);
+        if (!(options.targetHz > 0.0)) {
+            throw std::runtime_error("Frame rate must be positive: " + text);
+        }
+    }
+    return options;
+}
+
+FramePacer::FramePacer(const PacingOptions& options)
+    : pacing(options) {
+#ifdef _WIN32
+    // The default 15.6 ms timer tick would leave the pacer spinning most of every frame
+    timeBeginPeriod(1);
+#endif
+    if (pacing.mode == PacingMode::Target) {
+        period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / pacing.targetHz));
+        // A guessed estimate is either too long (spinning whole frames at high rates) or too
+        // short (oversleeping until enough samples arrive), so measure a few sleeps up front
+        for (int i = 0; i < 4; ++i) {
+            measureSleep();
+        }
+        totals = {};
+    }
+    restart();
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::waitForNextFrame() {
+    if (pacing.mode != PacingMode::Target) {
+        return;
+    }
+    TraceScope scope("FramePacing", "frame");
+    deadline += period;
+    Clock::time_point now = Clock::now();
+    if (now > deadline + period) {
+        // Too far behind to catch up without a burst of frames; start over
+        deadline = now;
+        return;
+    }
+    sleepUntil(deadline);
+}
+
+void FramePacer::restart() {
+    deadline = Clock::now();
+}
+
+const PacingOptions& FramePacer::options() const {
+    return pacing;
+}
+
+const PacerWaitTotals& FramePacer::waitTotals() const {
+    return totals;
+}
+
+void FramePacer::measureSleep() {
+    auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    double observed = std::chrono::duration<double>(Clock::now() - start).count();
+    totals.sleepSeconds += observed;
+
+    // Budget for the mean plus one standard deviation of what a sleep has cost so far
+    ++sleepCount;
+    double delta = observed - sleepMeanSeconds;
+    sleepMeanSeconds += delta / sleepCount;
+    sleepM2 += delta * (observed - sleepMeanSeconds);
+    sleepEstimateSeconds = sleepMeanSeconds + (sleepCount > 1 ? std::sqrt(sleepM2 / (sleepCount - 1)) : 0.0);
+}
+
+void FramePacer::sleepUntil(Clock::time_point until) {
+    while (std::chrono::duration<double>(until - Clock::now()).count() > sleepEstimateSeconds) {
+        measureSleep();
+    }
+    auto spinStart = Clock::now();
+    while (Clock::now() < until) {
+        std::this_thread::yield();
+    }
+    totals.spinSeconds += std::chrono::duration<double>(Clock::now() - spinStart).count();
+}
+
+namespace {
+    struct PacingError {
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        double spinShare = 0.0; // Fraction of the waiting time spent spinning
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    // Busy work standing in for update and draw, between 10% and 60% of the frame
+    void simulateFrameWork(Clock::duration period, int frame) {
+        auto until = Clock::now() + period * (10 + (frame * 37) % 51) / 100;
+        while (Clock::now() < until) {}
+    }
+
+    // How far each frame-to-frame interval is from the period
+    PacingError summarize(const std::vector<Clock::time_point>& frameStarts, Clock::duration period) {
+        std::vector<double> errors;
+        for (std::size_t i = 1; i < frameStarts.size(); ++i) {
+            errors.push_back(std::abs(std::chrono::duration<double>(frameStarts[i] - frameStarts[i - 1] - period).count()));
+        }
+        std::sort(errors.begin(), errors.end());
+        PacingError result;
+        result.p50Ms = errors[errors.size() / 2] * 1000.0;
+        result.p95Ms = errors[errors.size() * 95 / 100] * 1000.0;
+        result.p99Ms = errors[errors.size() * 99 / 100] * 1000.0;
+        result.maxMs = errors.back() * 1000.0;
+        return result;
+    }
+
+    PacingError measurePacer(double hz, int frames) {
+        FramePacer pacer({ PacingMode::Target, hz });
+        auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+        std::vector<Clock::time_point> frameStarts;
+        frameStarts.reserve(frames + 1);
+        pacer.restart();
+        frameStarts.push_back(Clock::now());
+        for (int frame = 0; frame < frames; ++frame) {
+            simulateFrameWork(period, frame);
+            pacer.waitForNextFrame();
+            frameStarts.push_back(Clock::now());
+        }
+        PacingError result = summarize(frameStarts, period);
+        const PacerWaitTotals& totals = pacer.waitTotals();
+        double waited = totals.sleepSeconds + totals.spinSeconds;
+        result.spinShare = waited > 0.0 ? totals.spinSeconds / waited : 0.0;
+        return result;
+    }
+
+    // What setFramerateLimit does: sleep for whatever is left of the period
+    PacingError measureSleepOnly(double hz, int frames) {
+        auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+        std::vector<Clock::time_point> frameStarts;
+        frameStarts.reserve(frames + 1);
+        frameStarts.push_back(Clock::now());
+        for (int frame = 0; frame < frames; ++frame) {
+            simulateFrameWork(period, frame);
+            std::this_thread::sleep_for(period - (Clock::now() - frameStarts.back()));
+            frameStarts.push_back(Clock::now());
+        }
+        return summarize(frameStarts, period);
+    }
+}
+
+int runPacerSelfTest() {
+#ifdef _WIN32
+    timeBeginPeriod(1);
+#endif
+    const double rates[] = { 60.0, 120.0, 144.0, 240.0 };
+    constexpr double seconds = 3.0;
+    bool passed = true;
+    std::cout << "Frame pacer self-test: deviation of frame intervals from the period\n";
+    std::cout << "   Hz  method       p50 ms   p95 ms   p99 ms   max ms   spin %\n";
+    for (double hz : rates) {
+        int frames = static_cast<int>(hz * seconds);
+        PacingError sleepOnly = measureSleepOnly(hz, frames);
+        PacingError paced = measurePacer(hz, frames);
+        // Spinning keeps a core busy, so a good part of the wait has to be spent asleep
+        passed = passed && paced.p95Ms < 0.5 && paced.spinShare < 0.75;
+        auto row = [hz](const char* method, const PacingError& error) {
+            std::cout << std::fixed << std::setprecision(0) << std::setw(5) << hz << "  " << std::left << std::setw(10) << method << std::right
+                << std::setprecision(3) << std::setw(9) << error.p50Ms << std::setw(9) << error.p95Ms << std::setw(9) << error.p99Ms << std::setw(9) << error.maxMs
+                << std::setprecision(0) << std::setw(9) << error.spinShare * 100.0 << "\n";
+        };
+        row("sleep", sleepOnly);
+        row("pacer", paced);
+    }
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+    std::cout << (passed ? "Pacer p95 error under 0.5 ms and sleeping for at least a quarter of its wait at every rate\n"
+        : "ERROR: pacer missed deadlines by more than 0.5 ms (p95) or spun for over three quarters of its wait\n");
+    return passed ? 0 : 1;
+}
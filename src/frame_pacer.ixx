@@ -0,0 +1,68 @@
+export module frame_pacer;
+
+import <chrono>;
+import <cstdint>;
+import <string>;
+
+export enum class PacingMode {
+    Target,   // Frames start on a fixed schedule at the target rate
+    Uncapped, // No waiting at all
+    VSync,    // The driver blocks in display(); the pacer does nothing
+};
+
+export struct PacingOptions {
+    PacingMode mode = PacingMode::Target;
+    double targetHz = 120.0;
+};
+
+// Parses "uncapped", "vsync" or a rate in Hz
+export PacingOptions parsePacingOptions(const std::string& text);
+
+// How a pacer spent its waiting time
+export struct PacerWaitTotals {
+    double sleepSeconds = 0.0;
+    double spinSeconds = 0.0;
+};
+
+// Replaces sf::Window::setFramerateLimit, whose sf::sleep can overshoot by a millisecond or
+// more. Waits in two steps: short sleeps while the deadline is further away than a sleep is
+// likely to take (measured when the pacer starts, then learned from every sleep), then a
+// spin for the rest. Deadlines advance by exactly one period, so an early or late frame does
+// not shift later ones.
+export class FramePacer {
+public:
+    explicit FramePacer(const PacingOptions& options);
+    ~FramePacer();
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Call once per frame after display(); returns at the next frame's start
+    void waitForNextFrame();
+    // Starts a new schedule from now, e.g. after the loop blocked on input
+    void restart();
+    const PacingOptions& options() const;
+    const PacerWaitTotals& waitTotals() const;
+private:
+    using Clock = std::chrono::steady_clock;
+
+    PacingOptions pacing;
+    Clock::duration period{};
+    Clock::time_point deadline;
+
+    // Running mean and variance of how long a 1 ms sleep really takes (Welford)
+    double sleepEstimateSeconds = 0.0;
+    double sleepMeanSeconds = 0.0;
+    double sleepM2 = 0.0;
+    std::int64_t sleepCount = 0;
+    PacerWaitTotals totals;
+
+    void measureSleep();
+    void sleepUntil(Clock::time_point until);
+};
+
+// Headless timing test: paces simulated frames at several rates, once with FramePacer and
+// once with a plain sleep as sf::sleep does, and prints how far frame intervals deviate from
+// the period and how much of the pacer's waiting was spent spinning. Returns 0 when the pacer
+// keeps the 95th percentile under half a millisecond and spins for at most three quarters
+// of its wait.
+export int runPacerSelfTest();
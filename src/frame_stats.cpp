@@ -0,0 +1,80 @@
+module frame_stats;
+
+import <algorithm>;
+import <cmath>;
+import <string>;
+import <iomanip>;
+import <numeric>;
+
+FrameStats::FrameStats(size_t expectedFrames) {
+    frameTimes.reserve(expectedFrames);
+}
+
+void FrameStats::addFrame(float seconds) {
+    frameTimes.push_back(seconds);
+}
+
+void FrameStats::reset() {
+    frameTimes.clear();
+}
+
+size_t FrameStats::frameCount() const {
+    return frameTimes.size();
+}
+
+void FrameStats::report(std::ostream& out) const {
+    if (frameTimes.empty()) {
+        out << "No frames recorded\n";
+        return;
+    }
+    std::vector<float> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) {
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+        return sorted[index] * 1000.0;
+    };
+    double total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+    double averageMs = total * 1000.0 / sorted.size();
+
+    // "1% low" is the average frame rate over the slowest 1% of frames
+    auto lowFps = [&sorted](size_t fraction) {
+        size_t slowCount = std::max<size_t>(1, sorted.size() / fraction);
+        double slowTotal = std::accumulate(sorted.end() - slowCount, sorted.end(), 0.0);
+        return slowCount / slowTotal;
+    };
+
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(3)
+        << "Frames: " << sorted.size() << "\n"
+        << "Frame time ms: avg " << averageMs << ", min " << sorted.front() * 1000.0
+        << ", p50 " << percentile(0.50) << ", p95 " << percentile(0.95)
+        << ", p99 " << percentile(0.99) << ", max " << sorted.back() * 1000.0 << "\n"
+        << std::setprecision(1)
+        << "FPS: avg " << 1000.0 / averageMs << ", 1% low " << lowFps(100) << ", 0.1% low " << lowFps(1000) << "\n";
+
+    // Bucket width is a 1-2-5 step chosen so the p0.1..p99 range fits in about 16 rows;
+    // frames outside it are counted in the first and last rows
+    double lowMs = percentile(0.001);
+    double highMs = percentile(0.99);
+    double width = 0.01;
+    for (int step = 0; (highMs - lowMs) / width > 16.0; ++step) {
+        width *= step % 3 == 1 ? 2.5 : 2.0;
+    }
+    double firstEdge = std::floor(lowMs / width) * width;
+    size_t buckets = static_cast<size_t>((highMs - firstEdge) / width) + 1;
+    std::vector<size_t> counts(buckets, 0);
+    for (float frameTime : sorted) {
+        double bucket = std::floor((frameTime * 1000.0 - firstEdge) / width);
+        counts[static_cast<size_t>(std::clamp(bucket, 0.0, static_cast<double>(buckets - 1)))]++;
+    }
+    size_t largest = *std::max_element(counts.begin(), counts.end());
+    out << std::setprecision(2) << "Frame time histogram (ms):\n";
+    for (size_t i = 0; i < buckets; ++i) {
+        double from = firstEdge + i * width;
+        out << std::setw(8) << from << " - " << std::setw(6) << from + width << std::setw(8) << counts[i] << " "
+            << std::string(counts[i] * 40 / largest, '#') << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,16 @@
+export module frame_stats;
+
+import <ostream>;
+import <vector>;
+
+// Collects frame times and reports the distribution (average, percentiles, lows, histogram)
+export class FrameStats {
+public:
+    explicit FrameStats(size_t expectedFrames = 1 << 16);
+    void addFrame(float seconds);
+    void reset();
+    size_t frameCount() const;
+    void report(std::ostream& out) const;
+private:
+    std::vector<float> frameTimes;
+};
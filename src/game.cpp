@@ -3,27 +3,201 @@ import game_state_manager;
 import menu_state;
 import audio;
 import highscore;
+import launch_options;
+import worker_pool;
+import ball_benchmark;
+import alloc_selftest;
+import highscore_benchmark;
+import player_history;
+import player_store;
+import config;
+import level_catalog;
+import level_generator;
+import playing_state;
+import frame_stats;
+import frame_pacer;
+import asset_pack;
+import random_service;
+import trace;
+import flight_recorder;
+import alloc_tracker;
+import <exception>;
+import <iostream>;
+import <optional>;
+import <string>;
+import <vector>;
 
-int main() {
-    sf::RenderWindow window(sf::VideoMode(800, 600), "projectArkanoid");
-    window.setFramerateLimit(120);
+int runGame(int argc, char* argv[]) {
+    LaunchOptions options = parseLaunchOptions(argc, argv);
+    configureFlightRecorder(options.flightLogPath, options.hitchMilliseconds);
+    // Outlives every other object in main, so all threads have stopped when the trace is written
+    TraceSession traceSession(options.tracePath);
+    nameTraceThread("Main");
+    setAllocationAssertions(options.allocationAssertions);
+
+    if (options.packAssets) {
+        int count = writeAssetPack("assets", options.assetPack);
+        std::cout << "Packed " << count << " files into " << options.assetPack << "\n";
+        return 0;
+    }
+    if (options.compactPlayers) {
+        HighScoreStorage storage;
+        migrateFlatPlayers(storage.playersDirectory);
+        CompactionReport report = compactPlayerHistories(storage.playersDirectory, 0);
+        std::cout << "Compacted history of " << report.compacted << " of " << report.players << " players: "
+            << report.bytesBefore << " -> " << report.bytesAfter << " bytes\n";
+        return 0;
+    }
+    if (!mountAssetPack(options.assetPack)) {
+        std::cout << "No asset pack found, loading loose files from assets/\n";
+    }
+
+    LevelCatalog levelCatalog;
+    if (options.embeddedLevels) {
+        levelCatalog.useEmbeddedLevels();
+    }
+    else {
+        levelCatalog.scan();
+    }
+    if (!options.levelPackOutput.empty()) {
+        std::vector<std::string> levelFiles;
+        for (int number = 1; number <= levelCatalog.count(); ++number) {
+            std::string path = levelCatalog.filePath(number);
+            if (!path.empty()) {
+                levelFiles.push_back(path);
+            }
+        }
+        int count = writeLevelPack(levelFiles, options.levelPackOutput);
+        std::cout << "Packed " << count << " levels into " << options.levelPackOutput << "\n";
+        return 0;
+    }
+
+    std::optional<LevelConfig> stressLevel;
+    if (options.generateLevel) {
+        stressLevel = generateLevel(options.generator);
+        if (!options.generatorOutput.empty()) {
+            saveLevelConfig(*stressLevel, options.generatorOutput);
+            std::cout << "Level written to " << options.generatorOutput << "\n";
+            if (!options.stressPlay) {
+                return 0;
+            }
+        }
+    }
+
+    RandomService randomService(options.seed ? *options.seed : RandomService::randomSeed());
+    std::cout << "Session seed: " << randomService.getSessionSeed() << " (replay with --seed)\n";
 
     AudioManager audioManager;
-    HighScoreManager highScoreManager;
+    if (options.benchBalls > 0) {
+        return runBallBenchmark(audioManager, levelCatalog.load(1), options.benchBalls, options.workerThreads + 1, randomService.getSessionSeed());
+    }
+    if (options.benchHighScores > 0) {
+        return runHighScoreBenchmark(options.benchHighScores);
+    }
+    if (options.pacerSelfTest) {
+        return runPacerSelfTest();
+    }
+    if (options.allocationSelfTest) {
+        return runAllocationSelfTest(audioManager, levelCatalog.load(1), options.workerThreads, randomService.getSessionSeed());
+    }
+
+    sf::RenderWindow window(sf::VideoMode(800, 600), "projectArkanoid");
+    // Stress play measures raw frame cost, so it runs uncapped unless asked otherwise
+    PacingOptions pacing = options.pacing.value_or(options.stressPlay ? PacingOptions{ PacingMode::Uncapped } : PacingOptions{});
+    window.setVerticalSyncEnabled(pacing.mode == PacingMode::VSync);
+    FramePacer framePacer(pacing);
+
+    WorkerPool workerPool(options.workerThreads);
+    HighScoreStorage highScoreStorage;
+    highScoreStorage.syncWrites = options.highScoreSync;
+    HighScoreManager highScoreManager(highScoreStorage);
     GameStateManager stateManager;
-    stateManager.setState<MenuState>(stateManager, audioManager, highScoreManager);
+    stateManager.setLaunchOptions(options);
+    stateManager.setWorkerPool(&workerPool);
+    stateManager.setRandomService(&randomService);
+    stateManager.setLevelCatalog(&levelCatalog);
+    if (options.stressPlay && options.endless) {
+        std::cout << "Stress play: endless mode\n";
+        stateManager.setNickname("Stress");
+        stateManager.setState<PlayingState>(stateManager, audioManager, highScoreManager, endlessLevelNumber);
+    }
+    else if (options.stressPlay) {
+        if (!stressLevel) {
+            stressLevel = levelCatalog.load(1);
+        }
+        std::cout << "Stress play: " << stressLevel->layout.rows << "x" << stressLevel->layout.columns << " layout\n";
+        stateManager.setGeneratedLevel(*stressLevel);
+        stateManager.setNickname("Stress");
+        stateManager.setState<PlayingState>(stateManager, audioManager, highScoreManager, generatedLevelNumber);
+    }
+    else {
+        stateManager.showState<MenuState>(stateManager, audioManager, highScoreManager);
+    }
+    stateManager.applyPendingTransitions();
 
+    FrameStats frameStats;
+    float allocationReportTimer = 0.0f;
     sf::Clock clock;
     while (window.isOpen()) {
         sf::Event event;
+        // Menu screens are static, so block until input arrives instead of redrawing at full rate
+        // (unless a prefetch is waiting for its turn to start)
+        if (!stateManager.needsContinuousUpdate() && !stateManager.hasQueuedPrefetch()) {
+            if (window.waitEvent(event)) {
+                stateManager.handleEvents(window, event);
+            }
+            // Time spent waiting must not leak into the next simulation step
+            clock.restart();
+            framePacer.restart();
+        }
+        TraceScope frameScope("Frame", "frame");
         while (window.pollEvent(event)) {
+            TraceScope scope("HandleEvent", "state");
+            AllocationZone allocationZone("HandleEvent");
             stateManager.handleEvents(window, event);
         }
+        if (!window.isOpen()) {
+            break;
+        }
 
         float deltaTime = clock.restart().asSeconds();
         stateManager.update(deltaTime);
+        // Transitions requested by handleEvents/update take effect here, before the new
+        // top state is drawn
+        stateManager.applyPendingTransitions();
         stateManager.draw(window);
+        framePacer.waitForNextFrame();
+        recordFrame(deltaTime);
+        if (options.allocationReport) {
+            markAllocationFrame();
+            allocationReportTimer += deltaTime;
+            if (allocationReportTimer >= 5.0f) {
+                allocationReportTimer = 0.0f;
+                reportAllocationStats(std::cout);
+            }
+        }
+        if ((options.stressPlay || options.frameStats) && stateManager.needsContinuousUpdate()) {
+            frameStats.addFrame(deltaTime);
+        }
     }
 
+    if (options.stressPlay || options.frameStats) {
+        frameStats.report(std::cout);
+    }
+    if (options.allocationReport) {
+        reportAllocationStats(std::cout);
+    }
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[]) {
+    // Bad options and damaged assets end here with a message instead of std::terminate
+    try {
+        return runGame(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        dumpFlightRecorder("unhandled exception", e.what());
+        return 1;
+    }
+}
@@ -8,5 +8,7 @@ public:
     virtual void draw(sf::RenderWindow& window) = 0;
     virtual sf::FloatRect getBounds() const = 0;
     virtual bool isDestroyed() const { return false; }
+    // Temporarily out of play (e.g. a lost ball waiting for reset) but not gone for good
+    virtual bool isCollidable() const { return !isDestroyed(); }
     virtual ~GameObject() = default;
 };
\ No newline at end of file
@@ -2,14 +2,84 @@ module game_object_manager;
 
 import <stdexcept>;
 import <iostream>;
+import <cmath>;
+import <algorithm>;
+import trace;
+
+namespace {
+    // Indexed by the variant of a level cell
+    const sf::Color normalBlockColors[blockVariantCount] = {
+        sf::Color::Green,
+        sf::Color(0, 170, 255),
+        sf::Color(255, 140, 0),
+        sf::Color(180, 80, 255),
+    };
+
+    const float blockWidth = 50.0f;
+    const float blockHeight = 20.0f;
+    const float blockSpacing = 8.0f;
+    const float paddleTop = 575.0f;
+    // Drops in play at once, per pool. Levels with fewer bonus blocks get smaller pools; past
+    // this many, and in endless mode where rows keep coming, further drops are skipped
+    const size_t maxPooledDrops = 64;
+
+    size_t countBonusCells(const LevelGrid& layout) {
+        return std::count_if(layout.cells.begin(), layout.cells.end(),
+            [](const LevelCell& cell) { return cell.type == CellType::Bonus; });
+    }
+}
 
 void GameObjectManager::add(std::unique_ptr<GameObject> obj) {
+    GameObject* object = obj.get();
+    addToBroadphase(object);
+    if (auto ball = dynamic_cast<Ball*>(object)) {
+        ballObjects.push_back(ball);
+    }
+    else if (auto bonus = dynamic_cast<Bonus*>(object)) {
+        bonusObjects.push_back(bonus);
+    }
     objects.push_back(std::move(obj));
 }
 
+// Moving objects take part in the broadphase; blocks are static and handled separately
+void GameObjectManager::addToBroadphase(GameObject* object) {
+    if (dynamic_cast<Paddle*>(object)) {
+        broadphase.add(object, CollisionLayer::Paddle, CollisionLayer::Ball | CollisionLayer::Bonus);
+    }
+    else if (dynamic_cast<Ball*>(object)) {
+        broadphase.add(object, CollisionLayer::Ball, CollisionLayer::Paddle);
+    }
+    else if (dynamic_cast<Bonus*>(object)) {
+        broadphase.add(object, CollisionLayer::Bonus, CollisionLayer::Paddle);
+    }
+}
+
 void GameObjectManager::update(float deltaTime) {
+    TraceScope scope("UpdateObjects", "sim");
+    parallelBalls.clear();
     for (auto& obj : objects) {
-        if (!obj->isDestroyed()) obj->update(deltaTime);
+        if (obj->isDestroyed()) continue;
+        if (workerPool) {
+            if (auto ball = dynamic_cast<Ball*>(obj.get())) {
+                // Parked balls do nothing in update, so they are not handed to the workers
+                if (!ball->isOutOfBounds()) {
+                    parallelBalls.push_back(ball);
+                }
+                continue;
+            }
+        }
+        obj->update(deltaTime);
+    }
+    // Balls move independently of each other, so they can be integrated in parallel
+    if (!parallelBalls.empty()) {
+        auto updateBalls = [&](size_t begin, size_t end) {
+            TraceScope chunkScope("UpdateBallChunk", "sim");
+            for (size_t i = begin; i < end; ++i) {
+                parallelBalls[i]->update(deltaTime);
+            }
+        };
+        // Passed by reference so the std::function parameter never heap-allocates a copy
+        workerPool->parallelFor(parallelBalls.size(), std::ref(updateBalls));
     }
 }
 
@@ -22,92 +92,340 @@ void GameObjectManager::draw(sf::RenderWindow& window) {
     }
 }
 
-void GameObjectManager::reset(float paddleWidth, float ballSpeed, const std::vector<std::string>& levelLayout) {
+void GameObjectManager::reset(float paddleWidth, float ballSpeed, const LevelGrid& levelLayout) {
+    TraceScope scope("BuildLevel", "level");
+    resetObjects(paddleWidth, ballSpeed);
+    placeAllBlocks(levelLayout);
+    // A level can drop at most one bonus, and so at most one extra ball, per bonus block
+    preallocatePools(countBonusCells(levelLayout));
+    std::cout << "GameObjectManager reset completed. Total objects: " << objects.size() << "\n";
+}
+
+void GameObjectManager::resetObjects(float paddleWidth, float ballSpeed) {
+    broadphase.clear();
     objects.clear();
+    ballObjects.clear();
+    bonusObjects.clear();
+    endless = {};
+    score = 0;
     std::cout << "Resetting GameObjectManager...\n";
-    add(std::make_unique<Paddle>(450, 575, paddleWidth));
+    add(std::make_unique<Paddle>(450, paddleTop, paddleWidth));
     add(std::make_unique<Ball>(400, 300, ballSpeed)); // Usunięto ballColor
+}
 
-    const float blockWidth = 50.0f;
-    const float blockHeight = 20.0f;
-    const float spacing = 8.0f;
-    const float startY = 100.0f;
+void GameObjectManager::resetEndless(float paddleWidth, float ballSpeed, const LevelGrid& initialRows) {
+    TraceScope scope("BuildEndless", "level");
+    resetObjects(paddleWidth, ballSpeed);
+    currentLayout = {};
+    cellBlocks.clear();
+    setGridGeometry(initialRows.columns, 0.0f, 1.0f);
 
-    for (size_t j = 0; j < levelLayout.size(); ++j) {
-        const auto& row = levelLayout[j];
-        std::cout << "Processing row " << j << ": " << row << "\n";
-        if (row.empty()) {
-            std::cerr << "Warning: Empty row in levelLayout at index " << j << "\n";
-            continue;
-        }
-        float totalWidth = row.size() * (blockWidth + spacing) - spacing;
-        float startX = (800.0f - totalWidth) / 2.0f;
-        for (size_t i = 0; i < row.size(); ++i) {
-            float x = startX + i * (blockWidth + spacing);
-            float y = startY + j * (blockHeight + spacing);
-            try {
-                if (row[i] == '1') {
-                    add(std::make_unique<NormalBlock>(x, y));
-                }
-                else if (row[i] == '2') {
-                    add(std::make_unique<IndestructibleBlock>(x, y));
-                }
-                else if (row[i] == '3') {
-                    add(std::make_unique<BonusBlock>(x, y));
-                }
-                else {
-                    std::cerr << "Warning: Invalid block type '" << row[i] << "' at row " << j << ", col " << i << "\n";
-                }
-            }
-            catch (const std::exception& e) {
-                std::cerr << "Error creating block at (" << x << ", " << y << "): " << e.what() << "\n";
-            }
-        }
+    endless.rows = initialRows.rows;
+    endless.columns = initialRows.columns;
+    endless.lowestRow = endless.rows - 1;
+    endless.lowestRowTop = paddleTop - grid.cellHeight;
+    grid.top = endless.lowestRowTop - (endless.rows - 1) * grid.cellHeight;
+    endless.cells.resize(endless.rows * endless.columns);
+    objects.reserve(objects.size() + 3 * endless.cells.size());
+    std::cout << "Placing an endless ring of " << endless.rows << "x" << endless.columns << " cells\n";
+    for (auto& cell : endless.cells) {
+        auto normal = std::make_unique<NormalBlock>(0.0f, 0.0f, normalBlockColors[0], grid.blockWidth, grid.blockHeight);
+        auto indestructible = std::make_unique<IndestructibleBlock>(0.0f, 0.0f, grid.blockWidth, grid.blockHeight);
+        auto bonus = std::make_unique<BonusBlock>(0.0f, 0.0f, grid.blockWidth, grid.blockHeight);
+        cell = { normal.get(), indestructible.get(), bonus.get() };
+        add(std::move(normal));
+        add(std::move(indestructible));
+        add(std::move(bonus));
     }
-    score = 0;
+    for (size_t row = 0; row < endless.rows; ++row) {
+        fillEndlessRow(row, &initialRows.at(row, 0), grid.top + row * grid.cellHeight);
+    }
+    rebuildBlockLayout();
+    // Rows keep coming, so there is no bound on the drops
+    preallocatePools(maxPooledDrops);
     std::cout << "GameObjectManager reset completed. Total objects: " << objects.size() << "\n";
 }
 
-std::vector<GameObject*> GameObjectManager::getBlocks() {
-    std::vector<GameObject*> blocks;
-    for (auto& obj : objects) {
-        if (dynamic_cast<Block*>(obj.get()) && !obj->isDestroyed()) {
-            blocks.push_back(obj.get());
+// Moves every block in play; destroyed ones are repositioned when their cell is refilled
+void GameObjectManager::scrollBlocks(float distance) {
+    if (endless.rows == 0) {
+        return;
+    }
+    for (auto block : layoutBlocks) {
+        if (!block->isDestroyed()) {
+            block->moveBy(distance);
         }
     }
-    return blocks;
+    endless.lowestRowTop += distance;
+    layoutScroll += distance;
 }
 
-std::vector<Bonus*> GameObjectManager::getBonuses() {
-    std::vector<Bonus*> bonuses;
-    for (auto& obj : objects) {
-        if (auto bonus = dynamic_cast<Bonus*>(obj.get())) {
-            if (!bonus->isDestroyed()) {
-                bonuses.push_back(bonus);
-            }
+bool GameObjectManager::lowestRowReachedPaddle() const {
+    return endless.rows > 0 && endless.lowestRowTop + grid.blockHeight >= paddleTop;
+}
+
+void GameObjectManager::recycleLowestRow(const LevelCell* cells) {
+    if (endless.rows == 0) {
+        return;
+    }
+    float top = endless.lowestRowTop - endless.rows * grid.cellHeight;
+    fillEndlessRow(endless.lowestRow, cells, top);
+    endless.lowestRow = endless.lowestRow == 0 ? endless.rows - 1 : endless.lowestRow - 1;
+    endless.lowestRowTop -= grid.cellHeight;
+    // Colours and hit points of the refilled row are part of the layout
+    rebuildBlockLayout();
+}
+
+void GameObjectManager::fillEndlessRow(size_t ringRow, const LevelCell* cells, float top) {
+    float startX = (800.0f - (endless.columns * grid.cellWidth - grid.spacing)) / 2.0f;
+    for (size_t i = 0; i < endless.columns; ++i) {
+        auto& slots = endless.cells[ringRow * endless.columns + i];
+        for (auto block : slots) {
+            block->retire();
         }
+        const LevelCell& cell = cells[i];
+        if (cell.type == CellType::Empty) continue;
+        Block* block = slots[static_cast<size_t>(cell.type) - 1];
+        if (cell.type == CellType::Normal) {
+            block->setColor(normalBlockColors[cell.variant % blockVariantCount]);
+        }
+        block->moveTo(startX + i * grid.cellWidth, top);
+        block->revive(cell.hitPoints);
     }
-    return bonuses;
 }
 
-std::vector<Ball*> GameObjectManager::getBalls() {
-    std::vector<Ball*> balls;
-    for (auto& obj : objects) {
-        if (auto ball = dynamic_cast<Ball*>(obj.get())) {
-            if (!ball->isOutOfBounds()) {
-                balls.push_back(ball);
+// Swaps in an edited layout without touching the paddle, balls, bonuses or score. Only cells
+// whose character changed get a new block; blocks already destroyed in unchanged cells stay
+// destroyed. Returns the number of rebuilt cells.
+int GameObjectManager::applyLayoutChanges(const LevelGrid& levelLayout) {
+    TraceScope scope("ApplyLayoutChanges", "level");
+    bool sameShape = levelLayout.rows == currentLayout.rows && levelLayout.columns == currentLayout.columns;
+    if (!sameShape) {
+        // Geometry depends on the grid size, so every block moves
+        std::erase_if(objects, [](const std::unique_ptr<GameObject>& obj) {
+            return dynamic_cast<const Block*>(obj.get()) != nullptr;
+        });
+        placeAllBlocks(levelLayout);
+        preallocatePools(countBonusCells(levelLayout));
+        return static_cast<int>(cellBlocks.size());
+    }
+
+    struct ChangedCell {
+        size_t row;
+        size_t column;
+        size_t index; // Into cellBlocks
+    };
+    std::vector<ChangedCell> changedCells;
+    size_t index = 0;
+    for (size_t j = 0; j < levelLayout.rows; ++j) {
+        for (size_t i = 0; i < levelLayout.columns; ++i, ++index) {
+            if (levelLayout.cells[index] != currentLayout.cells[index]) {
+                changedCells.push_back({ j, i, index });
             }
         }
     }
-    return balls;
+    if (changedCells.empty()) {
+        return 0;
+    }
+
+    std::vector<const Block*> replaced;
+    replaced.reserve(changedCells.size());
+    for (const auto& cell : changedCells) {
+        if (cellBlocks[cell.index]) {
+            replaced.push_back(cellBlocks[cell.index]);
+        }
+    }
+    removeBlocks(replaced);
+    currentLayout = levelLayout;
+    for (const auto& cell : changedCells) {
+        cellBlocks[cell.index] = placeBlock(levelLayout.cells[cell.index], cell.row, cell.column);
+    }
+    preallocatePools(countBonusCells(levelLayout));
+    rebuildBlockLayout();
+    return static_cast<int>(changedCells.size());
 }
 
-Ball* GameObjectManager::getBall() {
+void GameObjectManager::placeAllBlocks(const LevelGrid& levelLayout) {
+    const float startY = 100.0f;
+    const float fieldBottom = 280.0f; // Keep the area around the ball spawn point free
+
+    // Large layouts are scaled down so every column and row fits on screen
+    size_t columns = levelLayout.columns;
+    size_t rows = levelLayout.rows;
+    float fieldTop = rows * (blockHeight + blockSpacing) > fieldBottom - startY ? 40.0f : startY;
+    float scaleY = rows == 0 ? 1.0f : std::min(1.0f, (fieldBottom - fieldTop) / (rows * (blockHeight + blockSpacing)));
+    setGridGeometry(columns, fieldTop, scaleY);
+
+    currentLayout = levelLayout;
+    cellBlocks.clear();
+    cellBlocks.reserve(levelLayout.cells.size());
+    std::cout << "Placing " << rows << "x" << columns << " blocks\n";
+    for (size_t j = 0; j < rows; ++j) {
+        for (size_t i = 0; i < columns; ++i) {
+            cellBlocks.push_back(placeBlock(levelLayout.at(j, i), j, i));
+        }
+    }
+    rebuildBlockLayout();
+}
+
+void GameObjectManager::setGridGeometry(size_t columns, float fieldTop, float scaleY) {
+    float scaleX = columns > 0 ? std::min(1.0f, 780.0f / (columns * (blockWidth + blockSpacing))) : 1.0f;
+    grid.top = fieldTop;
+    grid.cellWidth = (blockWidth + blockSpacing) * scaleX;
+    grid.cellHeight = (blockHeight + blockSpacing) * scaleY;
+    grid.spacing = blockSpacing * scaleX;
+    grid.blockWidth = blockWidth * scaleX;
+    grid.blockHeight = blockHeight * scaleY;
+}
+
+Block* GameObjectManager::placeBlock(const LevelCell& cell, size_t row, size_t column) {
+    float totalWidth = currentLayout.columns * grid.cellWidth - grid.spacing;
+    float startX = (800.0f - totalWidth) / 2.0f;
+    float x = startX + column * grid.cellWidth;
+    float y = grid.top + row * grid.cellHeight;
+    std::unique_ptr<Block> block;
+    try {
+        switch (cell.type) {
+        case CellType::Empty:
+            return nullptr;
+        case CellType::Normal:
+            block = std::make_unique<NormalBlock>(x, y, normalBlockColors[cell.variant % blockVariantCount],
+                grid.blockWidth, grid.blockHeight, cell.hitPoints);
+            break;
+        case CellType::Indestructible:
+            block = std::make_unique<IndestructibleBlock>(x, y, grid.blockWidth, grid.blockHeight);
+            break;
+        case CellType::Bonus:
+            block = std::make_unique<BonusBlock>(x, y, grid.blockWidth, grid.blockHeight);
+            break;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error creating block at (" << x << ", " << y << "): " << e.what() << "\n";
+        return nullptr;
+    }
+    Block* placed = block.get();
+    add(std::move(block));
+    return placed;
+}
+
+// One compacting pass over the objects; the sorted list keeps each lookup logarithmic
+void GameObjectManager::removeBlocks(std::vector<const Block*>& blocks) {
+    std::sort(blocks.begin(), blocks.end());
+    std::erase_if(objects, [&blocks](const std::unique_ptr<GameObject>& obj) {
+        auto block = dynamic_cast<const Block*>(obj.get());
+        return block && std::binary_search(blocks.begin(), blocks.end(), block);
+    });
+}
+
+// The renderer rebuilds its block geometry whenever this pointer changes
+void GameObjectManager::rebuildBlockLayout() {
+    auto layout = std::make_shared<BlockLayout>();
+    layout->blocks.reserve(layoutBlocks.size());
+    layoutBlocks.clear();
     for (auto& obj : objects) {
-        if (auto ball = dynamic_cast<Ball*>(obj.get())) {
-            return ball;
+        if (auto block = dynamic_cast<Block*>(obj.get())) {
+            layoutBlocks.push_back(block);
+            auto hitPoints = static_cast<std::uint8_t>(std::min(block->getHitsRemaining(), 255));
+            layout->blocks.push_back({ block->getBounds(), block->getColor(), block->getOutlineThickness(), hitPoints });
+        }
+    }
+    blockLayout = std::move(layout);
+    layoutScroll = 0.0f;
+    reserveScratchBuffers();
+}
+
+// Spawning never allocates (it may run inside a zero-allocation scope), so the pools are
+// filled up front. They only grow, and never past maxPooledDrops, so reloading a level whose
+// pools are already large enough adds nothing.
+void GameObjectManager::preallocatePools(size_t size) {
+    size = std::min(size, maxPooledDrops);
+    size_t pooledBalls = std::count_if(ballObjects.begin(), ballObjects.end(),
+        [](const Ball* ball) { return ball->isBonusBall(); });
+    size_t missingBonuses = size > bonusObjects.size() ? size - bonusObjects.size() : 0;
+    size_t missingBalls = size > pooledBalls ? size - pooledBalls : 0;
+    if (missingBonuses == 0 && missingBalls == 0) {
+        return;
+    }
+    objects.reserve(objects.size() + missingBonuses + missingBalls);
+    for (size_t i = 0; i < missingBonuses; ++i) {
+        auto bonus = std::make_unique<Bonus>(0.0f, 0.0f, BonusType::ExtendPaddle);
+        bonus->collect();
+        add(std::move(bonus));
+    }
+    for (size_t i = 0; i < missingBalls; ++i) {
+        auto ball = std::make_unique<Ball>(0.0f, 0.0f, 300.0f, "assets/bonus_ball.png");
+        ball->park();
+        add(std::move(ball));
+    }
+    reserveScratchBuffers();
+}
+
+void GameObjectManager::reserveScratchBuffers() {
+    activeBlocks.reserve(layoutBlocks.size());
+    activeBalls.reserve(ballObjects.size());
+    activeBonuses.reserve(bonusObjects.size());
+    parallelBalls.reserve(ballObjects.size());
+    broadphase.reserve(ballObjects.size() + bonusObjects.size() + 1);
+}
+
+void GameObjectManager::spawnBonus(float x, float y, BonusType type) {
+    for (auto bonus : bonusObjects) {
+        if (bonus->isDestroyed()) {
+            // Its proxy may not have been dropped by the broadphase yet
+            broadphase.remove(bonus);
+            bonus->respawn(x, y, type);
+            addToBroadphase(bonus);
+            return;
         }
     }
+    // Pool exhausted: the drop is skipped
+}
+
+void GameObjectManager::spawnBonusBall(float x, float y, float speed) {
+    for (auto ball : ballObjects) {
+        if (ball->isBonusBall() && ball->isOutOfBounds()) {
+            ball->respawn(x, y, speed);
+            return;
+        }
+    }
+    // Pool exhausted: no extra ball
+}
+
+const std::vector<Block*>& GameObjectManager::getBlocks() {
+    activeBlocks.clear();
+    for (auto block : layoutBlocks) {
+        if (!block->isDestroyed()) {
+            activeBlocks.push_back(block);
+        }
+    }
+    return activeBlocks;
+}
+
+const std::vector<Bonus*>& GameObjectManager::getBonuses() {
+    activeBonuses.clear();
+    for (auto bonus : bonusObjects) {
+        if (!bonus->isDestroyed()) {
+            activeBonuses.push_back(bonus);
+        }
+    }
+    return activeBonuses;
+}
+
+const std::vector<Ball*>& GameObjectManager::getBalls() {
+    activeBalls.clear();
+    for (auto ball : ballObjects) {
+        if (!ball->isOutOfBounds()) {
+            activeBalls.push_back(ball);
+        }
+    }
+    return activeBalls;
+}
+
+Ball* GameObjectManager::getBall() {
+    if (!ballObjects.empty()) {
+        return ballObjects.front();
+    }
     throw std::runtime_error("Ball not found in GameObjectManager");
 }
 
@@ -129,6 +447,9 @@ int GameObjectManager::getScore() const {
 }
 
 bool GameObjectManager::allDestructibleBlocksDestroyed() const {
+    if (endless.rows > 0) {
+        return false; // The endless field never runs out
+    }
     for (const auto& obj : objects) {
         if (auto block = dynamic_cast<Block*>(obj.get())) {
             if (!dynamic_cast<IndestructibleBlock*>(block) && !block->isDestroyed()) {
@@ -137,4 +458,57 @@ bool GameObjectManager::allDestructibleBlocksDestroyed() const {
         }
     }
     return true;
+}
+
+// Copies the renderable state into a reusable snapshot; buffers keep their capacity between ticks
+void GameObjectManager::captureSnapshot(WorldSnapshot& snapshot) {
+    ++snapshot.tick;
+    snapshot.balls.clear();
+    snapshot.bonuses.clear();
+    // Sized for every pooled object, so the buffers stop growing after their first use
+    snapshot.balls.reserve(ballObjects.size());
+    snapshot.bonuses.reserve(bonusObjects.size());
+    Paddle* paddle = getPaddle();
+    snapshot.paddlePosition = paddle->getPosition();
+    snapshot.paddleSize = paddle->getSize();
+    for (auto ball : ballObjects) {
+        if (!ball->isOutOfBounds()) {
+            snapshot.balls.push_back({ ball->getPosition(), ball->isBonusBall() });
+        }
+    }
+    for (auto bonus : bonusObjects) {
+        if (!bonus->isDestroyed()) {
+            snapshot.bonuses.push_back({ bonus->getBounds(), bonus->getColor() });
+        }
+    }
+    snapshot.blockLayout = blockLayout;
+    snapshot.blockScroll = layoutScroll;
+    snapshot.blockHits.resize(layoutBlocks.size());
+    for (size_t i = 0; i < layoutBlocks.size(); ++i) {
+        snapshot.blockHits[i] = static_cast<std::uint8_t>(std::min(layoutBlocks[i]->getHitsRemaining(), 255));
+    }
+    snapshot.score = score;
+}
+
+void GameObjectManager::setWorkerPool(WorkerPool* pool) {
+    workerPool = pool;
+}
+
+SweepAndPrune& GameObjectManager::getBroadphase() {
+    return broadphase;
+}
+
+// Fans extra balls out of the screen centre; directions follow the golden angle so every run is identical
+void GameObjectManager::spawnStressBalls(int count, float speed) {
+    const float goldenAngle = 2.39996323f;
+    objects.reserve(objects.size() + count);
+    for (int i = 0; i < count; ++i) {
+        float angle = i * goldenAngle;
+        auto ball = std::make_unique<Ball>(400.0f, 400.0f, speed);
+        // Always launch upwards so the balls are not lost immediately
+        ball->setVelocity({ std::cos(angle), -0.5f - std::abs(std::sin(angle)) });
+        add(std::move(ball));
+    }
+    reserveScratchBuffers();
+    std::cout << "Spawned " << count << " stress balls\n";
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 export module game_object_manager;
 
+import <array>;
 import <memory>;
 import <vector>;
 import <ranges>;
@@ -10,22 +11,90 @@ import paddle;
 import ball;
 import block;
 import bonus;
+import world_snapshot;
+import worker_pool;
+import broadphase;
+import config;
 
 export class GameObjectManager {
 public:
 	void add(std::unique_ptr<GameObject> obj);
 	void update(float deltaTime);
 	void draw(sf::RenderWindow& window);
-	void reset(float paddleWidth, float ballSpeed, const std::vector<std::string>& levelLayout);
-	std::vector<GameObject*> getBlocks();
-	std::vector<Bonus*> getBonuses();
-	std::vector<Ball*> getBalls();
+	void reset(float paddleWidth, float ballSpeed, const LevelGrid& levelLayout);
+	int applyLayoutChanges(const LevelGrid& levelLayout);
+	// Endless mode: the blocks form a fixed ring of initialRows.rows rows that scrolls down.
+	// Rows reaching the paddle line are refilled and moved back above the top row, so the
+	// number of blocks, and the cost of a tick, never changes.
+	void resetEndless(float paddleWidth, float ballSpeed, const LevelGrid& initialRows);
+	void scrollBlocks(float distance);
+	bool lowestRowReachedPaddle() const;
+	// Refills the row closest to the paddle with cells (one per column) and moves it to the top
+	void recycleLowestRow(const LevelCell* cells);
+	// Queries refill a buffer owned by the manager, so they do not allocate once a level is
+	// running; the returned reference is valid until the next call of the same query
+	const std::vector<Block*>& getBlocks();
+	const std::vector<Bonus*>& getBonuses();
+	const std::vector<Ball*>& getBalls();
 	Ball* getBall();
 	Paddle* getPaddle();
 	void addScore(int points);
 	int getScore() const;
 	bool allDestructibleBlocksDestroyed() const; // Added for level completion
+	void captureSnapshot(WorldSnapshot& snapshot);
+	void setWorkerPool(WorkerPool* pool);
+	SweepAndPrune& getBroadphase();
+	void spawnStressBalls(int count, float speed);
+	// Drops take a parked object from the pools filled by reset() and are skipped when every
+	// pooled object is already in play
+	void spawnBonus(float x, float y, BonusType type);
+	void spawnBonusBall(float x, float y, float speed);
 private:
 	std::vector<std::unique_ptr<GameObject>> objects;
+	std::vector<Ball*> parallelBalls;
+	WorkerPool* workerPool = nullptr;
+	SweepAndPrune broadphase;
+	std::vector<Block*> layoutBlocks;
+	std::vector<Ball*> ballObjects;   // Every ball owned by objects, in play or parked
+	std::vector<Bonus*> bonusObjects; // Every bonus owned by objects, falling or collected
+	std::vector<Block*> activeBlocks;
+	std::vector<Ball*> activeBalls;
+	std::vector<Bonus*> activeBonuses;
+	std::shared_ptr<const BlockLayout> blockLayout;
 	int score = 0;
+
+	// Where the current layout's cells are on screen, kept so single cells can be rebuilt
+	struct BlockGrid {
+		float top = 0.0f;
+		float cellWidth = 0.0f;
+		float cellHeight = 0.0f;
+		float spacing = 0.0f;
+		float blockWidth = 0.0f;
+		float blockHeight = 0.0f;
+	};
+	BlockGrid grid;
+	LevelGrid currentLayout;
+	std::vector<Block*> cellBlocks; // Row-major, nullptr for empty cells
+
+	// Every ring cell owns one block of each type and shows at most one of them
+	struct EndlessRing {
+		size_t rows = 0;
+		size_t columns = 0;
+		size_t lowestRow = 0; // Ring index of the row closest to the paddle
+		float lowestRowTop = 0.0f;
+		std::vector<std::array<Block*, 3>> cells; // Normal, indestructible, bonus
+	};
+	EndlessRing endless;
+	float layoutScroll = 0.0f; // How far the blocks moved since blockLayout was built
+
+	void resetObjects(float paddleWidth, float ballSpeed);
+	void placeAllBlocks(const LevelGrid& levelLayout);
+	void setGridGeometry(size_t columns, float fieldTop, float scaleY);
+	void fillEndlessRow(size_t ringRow, const LevelCell* cells, float top);
+	Block* placeBlock(const LevelCell& cell, size_t row, size_t column);
+	void removeBlocks(std::vector<const Block*>& blocks); // Sorts blocks
+	void rebuildBlockLayout();
+	void addToBroadphase(GameObject* object);
+	void preallocatePools(size_t size); // Grows both pools to size, capped at maxPooledDrops
+	void reserveScratchBuffers();
 };
\ No newline at end of file
@@ -1,21 +1,21 @@
 #include <iostream>
 module game_over_state;
+import asset_pack;
 
 import nickname_input_state;
 import menu_state;
 import <stdexcept>;
 import <vector>;
 
-GameOverState::GameOverState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm,int score)
-    : stateManager(sm), audioManager(am), highScoreManager(hsm), finalScore(score) {
-    if (!font.loadFromFile("assets/arial.ttf")) {
+GameOverState::GameOverState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm)
+    : stateManager(sm), audioManager(am), highScoreManager(hsm) {
+    if (!loadFont(font, "assets/arial.ttf")) {
         throw std::runtime_error("Failed to load font");
     }
-    if (!backgroundTexture.loadFromFile("assets/background2.png")) {
+    if (!loadTexture(backgroundTexture, "assets/background2.png")) {
         throw std::runtime_error("Failed to load background texture");
     }
     backgroundSprite.setTexture(backgroundTexture);
-    highScoreManager.addScore(stateManager.getNickname(), finalScore, stateManager.FcurrentLevel());
 
     overlay.setSize({ 800, 600 });
     overlay.setFillColor(sf::Color(0, 0, 0, 128));
@@ -27,13 +27,11 @@ GameOverState::GameOverState(GameStateManager& sm, AudioManager& am, HighScoreMa
     gameOverText.setPosition(300, 100);
 
     scoreText.setFont(font);
-    scoreText.setString("Your Score: " + std::to_string(finalScore));
     scoreText.setCharacterSize(30);
     scoreText.setFillColor(sf::Color::White);
     scoreText.setPosition(300, 200);
 
     highscoreText.setFont(font);
-    updateHighscoreText();
     highscoreText.setCharacterSize(20);
     highscoreText.setFillColor(sf::Color::White);
     highscoreText.setPosition(300, 250);
@@ -56,6 +54,23 @@ GameOverState::GameOverState(GameStateManager& sm, AudioManager& am, HighScoreMa
     exitText.setFillColor(sf::Color::White);
     exitText.setPosition(300, 450);
 }
+
+void GameOverState::setFinalScore(int score) {
+    finalScore = score;
+}
+
+void GameOverState::onEnter() {
+    // Generated and endless runs (levels 0 and -1, which includes stress play) stay off the
+    // leaderboard, as they do when a level is completed
+    if (stateManager.FcurrentLevel() >= 1) {
+        highScoreManager.addScore(stateManager.getNickname(), finalScore, stateManager.FcurrentLevel());
+    }
+    scoreText.setString("Your Score: " + std::to_string(finalScore));
+    updateHighscoreText();
+    restartText.setFillColor(sf::Color::White);
+    menuText.setFillColor(sf::Color::White);
+    exitText.setFillColor(sf::Color::White);
+}
 void GameOverState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
    sf::Vector2f mousePos;
     if (event.type == sf::Event::MouseMoved) {
@@ -71,11 +86,11 @@ void GameOverState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
 
         if (restartText.getGlobalBounds().contains(mousePos)) {
             std::cout << "Restart clicked\n";
-            stateManager.setState<NicknameInputState>(stateManager, audioManager, highScoreManager);
+            stateManager.showState<NicknameInputState>(stateManager, audioManager, highScoreManager).setStartLevel(1);
         }
         else if (menuText.getGlobalBounds().contains(mousePos)) {
             std::cout << "Main Menu clicked\n";
-            stateManager.setState<MenuState>(stateManager, audioManager, highScoreManager);
+            stateManager.showState<MenuState>(stateManager, audioManager, highScoreManager);
         }
         else if (exitText.getGlobalBounds().contains(mousePos)) {
             std::cout << "Exit clicked\n";
@@ -87,8 +102,11 @@ void GameOverState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
 void GameOverState::update(float deltaTime) {
 }
 
+bool GameOverState::needsContinuousUpdate() const {
+    return false;
+}
+
 void GameOverState::draw(sf::RenderWindow& window) {
-    window.clear(sf::Color::Black);
     window.draw(backgroundSprite);
     window.draw(overlay);
     window.draw(gameOverText);
@@ -97,7 +115,6 @@ void GameOverState::draw(sf::RenderWindow& window) {
     window.draw(restartText);
     window.draw(menuText);
     window.draw(exitText);
-    window.display();
 }
 
 void GameOverState::updateHighscoreText() {
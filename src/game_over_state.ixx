@@ -9,10 +9,13 @@ import highscore;
 
 export class GameOverState : public GameState {
 public:
-    GameOverState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int score);
+    GameOverState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm);
+    void setFinalScore(int score);
     void handleEvents(sf::RenderWindow& window, sf::Event& event) override;
     void update(float deltaTime) override;
     void draw(sf::RenderWindow& window) override;
+    bool needsContinuousUpdate() const override;
+    void onEnter() override;
 private:
     sf::Font font;
     sf::Text gameOverText;
@@ -25,7 +28,7 @@ private:
     GameStateManager& stateManager;
     AudioManager& audioManager;
     HighScoreManager& highScoreManager;
-    int finalScore;
+    int finalScore = 0;
     sf::Texture backgroundTexture;
     sf::Sprite backgroundSprite;
 
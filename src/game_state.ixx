@@ -7,5 +7,16 @@ public:
     virtual void handleEvents(sf::RenderWindow& window, sf::Event& event) = 0;
     virtual void update(float deltaTime) = 0;
     virtual void draw(sf::RenderWindow& window) = 0;
+    // Static screens return false so the main loop can sleep until the next input event
+    virtual bool needsContinuousUpdate() const { return true; }
+    // Overlays are drawn on top of the state below them instead of replacing it
+    virtual bool isOverlay() const { return false; }
+
+    // Stack hooks. Cached states are entered many times, so per-visit setup belongs in onEnter
+    virtual void onEnter() {}
+    virtual void onExit() {}
+    // Another state was pushed on top of this one / the state above was popped
+    virtual void onPause() {}
+    virtual void onResume() {}
     virtual ~GameState() = default;
-};
\ No newline at end of file
+};
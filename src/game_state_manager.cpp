@@ -1,5 +1,13 @@
 module game_state_manager;
 
+import <stdexcept>;
+import <iostream>;
+import <chrono>;
+import trace;
+import flight_recorder;
+import alloc_tracker;
+import <typeinfo>;
+
 void GameStateManager::setNickname(const std::string& nickname) {
     currentNickname = nickname;
 }
@@ -7,6 +15,52 @@ void GameStateManager::setNickname(const std::string& nickname) {
 std::string GameStateManager::getNickname() const {
     return currentNickname;
 }
+void GameStateManager::setLaunchOptions(const LaunchOptions& options) {
+    launchOptions = options;
+}
+
+const LaunchOptions& GameStateManager::getLaunchOptions() const {
+    return launchOptions;
+}
+
+void GameStateManager::setWorkerPool(WorkerPool* pool) {
+    workerPool = pool;
+}
+
+WorkerPool* GameStateManager::getWorkerPool() const {
+    return workerPool;
+}
+
+void GameStateManager::setRandomService(RandomService* service) {
+    randomService = service;
+}
+
+RandomService& GameStateManager::getRandom() {
+    if (!randomService) {
+        throw std::runtime_error("Random service not set");
+    }
+    return *randomService;
+}
+
+void GameStateManager::setLevelCatalog(const LevelCatalog* catalog) {
+    levelCatalog = catalog;
+}
+
+const LevelCatalog& GameStateManager::getLevelCatalog() const {
+    if (!levelCatalog) {
+        throw std::runtime_error("Level catalog not set");
+    }
+    return *levelCatalog;
+}
+
+void GameStateManager::setGeneratedLevel(const LevelConfig& level) {
+    generatedLevel = level;
+}
+
+const LevelConfig* GameStateManager::getGeneratedLevel() const {
+    return generatedLevel ? &*generatedLevel : nullptr;
+}
+
 int GameStateManager::FcurrentLevel() {
     return currentLevel;
 }
@@ -14,14 +68,183 @@ void GameStateManager::setcurrentLevel(const int& lvl) {
     currentLevel = lvl;
 }
 
+void GameStateManager::pushState(GameState& state) {
+    pending.push_back({ TransitionKind::Push, &state, nullptr });
+}
+
+void GameStateManager::popState() {
+    pending.push_back({ TransitionKind::Pop, nullptr, nullptr });
+}
+
+void GameStateManager::prefetchState(const std::string& key, std::function<std::unique_ptr<GameState>()> factory) {
+    if (prefetch && prefetch->key == key) {
+        queuedPrefetch.reset();
+        return;
+    }
+    if (queuedPrefetch && queuedPrefetch->key == key) {
+        return;
+    }
+    queuedPrefetch = QueuedPrefetch{ key, std::move(factory), std::chrono::steady_clock::now() + prefetchDelay };
+}
+
+bool GameStateManager::hasQueuedPrefetch() const {
+    return queuedPrefetch.has_value();
+}
+
+bool GameStateManager::prefetchRunning() const {
+    if (!discardedPrefetches.empty()) {
+        return true;
+    }
+    return prefetch && prefetch->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+// At most one build runs at a time; a newer request waits for it instead of piling up threads
+void GameStateManager::startQueuedPrefetch() {
+    if (!queuedPrefetch || std::chrono::steady_clock::now() < queuedPrefetch->startAt || prefetchRunning()) {
+        return;
+    }
+    QueuedPrefetch request = std::move(*queuedPrefetch);
+    queuedPrefetch.reset();
+    if (prefetch) {
+        // Already finished, so it is destroyed on the next reap
+        discardPrefetchedState();
+    }
+    std::cout << "Prefetching state " << request.key << "\n";
+    prefetch = Prefetch{ request.key, std::async(std::launch::async, [factory = std::move(request.factory)] {
+        nameTraceThread("Prefetch");
+        TraceScope scope("PrefetchState", "state");
+        return factory();
+    }) };
+}
+
+bool GameStateManager::commitPrefetchedState(const std::string& key) {
+    queuedPrefetch.reset();
+    if (!prefetch || prefetch->key != key) {
+        discardPrefetchedState();
+        return false;
+    }
+    auto result = std::move(prefetch->result);
+    prefetch.reset();
+    try {
+        std::unique_ptr<GameState> state = result.get();
+        pending.push_back({ TransitionKind::Replace, nullptr, std::move(state) });
+        std::cout << "Committed prefetched state " << key << "\n";
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Prefetch of " << key << " failed: " << e.what() << "\n";
+        return false;
+    }
+}
+
+// Never blocks: a prefetch that is still running is parked until it finishes
+void GameStateManager::discardPrefetchedState() {
+    queuedPrefetch.reset();
+    if (!prefetch) {
+        return;
+    }
+    std::cout << "Discarding prefetched state " << prefetch->key << "\n";
+    discardedPrefetches.push_back(std::move(prefetch->result));
+    prefetch.reset();
+}
+
+// Finished discarded states are destroyed here, on the main thread
+void GameStateManager::reapDiscardedPrefetches() {
+    std::erase_if(discardedPrefetches, [](auto& result) {
+        if (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return false;
+        }
+        try {
+            result.get();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Discarded prefetch failed: " << e.what() << "\n";
+        }
+        return true;
+    });
+}
+
+void GameStateManager::applyPendingTransitions() {
+    reapDiscardedPrefetches();
+    startQueuedPrefetch();
+    // Applying a transition may run onEnter/onExit hooks that queue further transitions
+    while (!pending.empty()) {
+        std::vector<Transition> transitions = std::move(pending);
+        pending.clear();
+        for (auto& transition : transitions) {
+            switch (transition.kind) {
+            case TransitionKind::Pop:
+                if (!stack.empty()) {
+                    recordTransition("Pop", typeid(*stack.back().state).name());
+                    stack.back().state->onExit();
+                    stack.pop_back();
+                    if (!stack.empty()) {
+                        stack.back().state->onResume();
+                    }
+                }
+                break;
+            case TransitionKind::Replace:
+                recordTransition("Replace with", typeName(transition));
+                while (!stack.empty()) {
+                    stack.back().state->onExit();
+                    stack.pop_back();
+                }
+                enterState(transition);
+                break;
+            case TransitionKind::Push:
+                recordTransition("Push", typeName(transition));
+                if (!stack.empty()) {
+                    stack.back().state->onPause();
+                }
+                enterState(transition);
+                break;
+            }
+        }
+    }
+}
+
+const char* GameStateManager::typeName(const Transition& transition) {
+    const GameState* state = transition.ownedState ? transition.ownedState.get() : transition.state;
+    return typeid(*state).name();
+}
+
+void GameStateManager::enterState(Transition& transition) {
+    GameState* state = transition.ownedState ? transition.ownedState.get() : transition.state;
+    stack.push_back({ state, std::move(transition.ownedState) });
+    state->onEnter();
+}
+
 void GameStateManager::handleEvents(sf::RenderWindow& window, sf::Event& event) {
-    if (currentState) currentState->handleEvents(window, event);
+    if (event.type == sf::Event::Closed) {
+        window.close();
+        return;
+    }
+    if (!stack.empty()) stack.back().state->handleEvents(window, event);
 }
 
 void GameStateManager::update(float deltaTime) {
-    if (currentState) currentState->update(deltaTime);
+    TraceScope scope("Update", "state");
+    AllocationZone allocationZone("Update");
+    if (!stack.empty()) stack.back().state->update(deltaTime);
 }
 
+// Draws from the topmost opaque state upwards, so overlays show the game underneath
 void GameStateManager::draw(sf::RenderWindow& window) {
-    if (currentState) currentState->draw(window);
+    TraceScope scope("Draw", "render");
+    AllocationZone allocationZone("Draw");
+    window.clear(sf::Color::Black);
+    size_t first = stack.size();
+    while (first > 0) {
+        --first;
+        if (!stack[first].state->isOverlay()) break;
+    }
+    for (size_t i = first; i < stack.size(); ++i) {
+        stack[i].state->draw(window);
+    }
+    TraceScope presentScope("Present", "render");
+    window.display();
+}
+
+bool GameStateManager::needsContinuousUpdate() const {
+    return stack.empty() || stack.back().state->needsContinuousUpdate();
 }
\ No newline at end of file
@@ -6,24 +6,127 @@ import <type_traits>;
 import <SFML/Graphics.hpp>;
 import <utility>;
 import game_state;
+import launch_options;
+import worker_pool;
+import config;
+import random_service;
+import level_catalog;
+import <optional>;
+import <typeindex>;
+import <typeinfo>;
+import <unordered_map>;
+import <vector>;
+import <functional>;
+import <future>;
+import <chrono>;
 
+// Owns a stack of states. Only the top state receives events and updates; overlays let
+// the states below them show through. Transitions requested during a frame are queued
+// and applied by applyPendingTransitions(), so a state is never destroyed while one of
+// its own member functions is running.
 export class GameStateManager {
 public:
+    // Replaces the whole stack with a newly constructed T
     template<typename T, typename... Args>
     void setState(Args&&... args) {
         static_assert(std::is_base_of_v<GameState, T>, "T must derive from GameState");
-        currentState = std::make_unique<T>(std::forward<Args>(args)...);
+        pending.push_back({ TransitionKind::Replace, nullptr, std::make_unique<T>(std::forward<Args>(args)...) });
     }
 
+    // Replaces the whole stack with the cached instance of T, constructing it on first use
+    // (later calls ignore args). Configure it through the returned reference; its onEnter
+    // runs when the transition is applied.
+    template<typename T, typename... Args>
+    T& showState(Args&&... args) {
+        static_assert(std::is_base_of_v<GameState, T>, "T must derive from GameState");
+        auto& cached = cachedStates[std::type_index(typeid(T))];
+        if (!cached) {
+            cached = std::make_unique<T>(std::forward<Args>(args)...);
+        }
+        pending.push_back({ TransitionKind::Replace, cached.get(), nullptr });
+        return static_cast<T&>(*cached);
+    }
+
+    // Pushes a state owned by someone else (e.g. an overlay owned by the state below it)
+    void pushState(GameState& state);
+    void popState();
+    void applyPendingTransitions();
+
+    // Speculatively builds a state on a background thread. key identifies what is being
+    // built (e.g. "level:2"); a prefetch with the same key is kept, any other is discarded.
+    // Requests only start once they have stood for prefetchDelay and no other build is
+    // running, so sweeping the mouse over a list queues one build rather than one per item.
+    // The factory must not touch shared state that the main thread may change meanwhile,
+    // nor create GL resources (fonts, textures).
+    void prefetchState(const std::string& key, std::function<std::unique_ptr<GameState>()> factory);
+    // Replaces the stack with the prefetched state if it matches key, waiting for it to finish
+    // if needed. Returns false (and the caller builds the state itself) on a miss or failure.
+    bool commitPrefetchedState(const std::string& key);
+    void discardPrefetchedState();
+    // True while a request waits to start; the main loop keeps polling so it is not stranded
+    bool hasQueuedPrefetch() const;
+
     void setNickname(const std::string& nickname);
 	void setcurrentLevel(const int& lvl);
 	int FcurrentLevel();
     std::string getNickname() const;
+    void setLaunchOptions(const LaunchOptions& options);
+    const LaunchOptions& getLaunchOptions() const;
+    void setWorkerPool(WorkerPool* pool);
+    WorkerPool* getWorkerPool() const;
+    void setRandomService(RandomService* service);
+    RandomService& getRandom();
+    void setLevelCatalog(const LevelCatalog* catalog);
+    const LevelCatalog& getLevelCatalog() const;
+    void setGeneratedLevel(const LevelConfig& level);
+    const LevelConfig* getGeneratedLevel() const;
     void handleEvents(sf::RenderWindow& window, sf::Event& event);
     void update(float deltaTime);
     void draw(sf::RenderWindow& window);
+    bool needsContinuousUpdate() const;
     int currentLevel;
 private:
-    std::unique_ptr<GameState> currentState;
+    enum class TransitionKind { Replace, Push, Pop };
+    struct Transition {
+        TransitionKind kind;
+        GameState* state = nullptr;            // Cached or externally owned state
+        std::unique_ptr<GameState> ownedState; // State constructed by setState
+    };
+    struct StackEntry {
+        GameState* state = nullptr;
+        std::unique_ptr<GameState> owned;
+    };
+
+    // Declared before the stack so cached states outlive everything that points at them
+    std::unordered_map<std::type_index, std::unique_ptr<GameState>> cachedStates;
+    std::vector<StackEntry> stack;
+    std::vector<Transition> pending;
+
+    void enterState(Transition& transition);
+    static const char* typeName(const Transition& transition);
+    void reapDiscardedPrefetches();
+    void startQueuedPrefetch();
+    bool prefetchRunning() const;
+
     std::string currentNickname;
+    LaunchOptions launchOptions;
+    WorkerPool* workerPool = nullptr;
+    RandomService* randomService = nullptr;
+    const LevelCatalog* levelCatalog = nullptr;
+    std::optional<LevelConfig> generatedLevel;
+
+    // Declared last so that, on shutdown, running prefetches finish before anything they use goes away
+    struct Prefetch {
+        std::string key;
+        std::future<std::unique_ptr<GameState>> result;
+    };
+    struct QueuedPrefetch {
+        std::string key;
+        std::function<std::unique_ptr<GameState>()> factory;
+        std::chrono::steady_clock::time_point startAt;
+    };
+    static constexpr std::chrono::milliseconds prefetchDelay{ 150 };
+    std::optional<QueuedPrefetch> queuedPrefetch; // Latest request only
+    std::optional<Prefetch> prefetch;
+    std::vector<std::future<std::unique_ptr<GameState>>> discardedPrefetches;
 };
\ No newline at end of file
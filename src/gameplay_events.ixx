@@ -0,0 +1,37 @@
+export module gameplay_events;
+
+import <SFML/Graphics.hpp>;
+import <cstddef>;
+import <cstdint>;
+import <vector>;
+import bonus;
+
+// What collision detection found during one tick. Detection only records these; score,
+// audio, spawning and bonus effects are applied afterwards by GameplaySystems.
+export enum class GameplayEventType : std::uint8_t {
+    PaddleContact,
+    BlockHit,       // Block survived the hit
+    BlockDestroyed,
+    BonusCollected
+};
+
+export struct GameplayEvent {
+    GameplayEventType type = GameplayEventType::PaddleContact;
+    BonusType bonusType = BonusType::ExtendPaddle; // BonusCollected only
+    bool fromBonusBlock = false;                   // BlockDestroyed only
+    sf::FloatRect bounds;                          // Block or bonus involved; the ball for paddle contacts
+};
+
+// Per-tick event buffer; cleared at the start of every tick and keeps its capacity
+export class GameplayEventQueue {
+public:
+    GameplayEventQueue() { events.reserve(256); }
+    void emit(const GameplayEvent& event) { events.push_back(event); }
+    void clear() { events.clear(); }
+    void reserve(std::size_t count) { events.reserve(count); }
+    bool empty() const { return events.empty(); }
+    std::vector<GameplayEvent>::const_iterator begin() const { return events.begin(); }
+    std::vector<GameplayEvent>::const_iterator end() const { return events.end(); }
+private:
+    std::vector<GameplayEvent> events;
+};
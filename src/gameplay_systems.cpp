@@ -0,0 +1,122 @@
+module gameplay_systems;
+
+import bonus;
+import ball;
+import paddle;
+import trace;
+import flight_recorder;
+
+namespace {
+    constexpr int blockPoints = 100;
+    constexpr int bonusBlockPoints = 500;
+}
+
+GameplaySystems::GameplaySystems(AudioManager& audio, Xoshiro256& random) : audioManager(audio), random(random) {}
+
+void GameplaySystems::process(const GameplayEventQueue& events, GameObjectManager& manager) {
+    if (events.empty()) {
+        return;
+    }
+    TraceScope scope("GameplayEvents", "sim");
+    recordTelemetry(events);
+    applyScore(events, manager);
+    playSounds(events);
+    applyBonusEffects(events, manager);
+    // Spawning last keeps new balls out of this tick's bonus effects
+    spawnObjects(events, manager);
+}
+
+void GameplaySystems::applyScore(const GameplayEventQueue& events, GameObjectManager& manager) {
+    int points = 0;
+    for (const auto& event : events) {
+        if (event.type == GameplayEventType::BlockDestroyed) {
+            points += event.fromBonusBlock ? blockPoints + bonusBlockPoints : blockPoints;
+        }
+    }
+    if (points > 0) {
+        manager.addScore(points);
+    }
+}
+
+// Each sound restarts when played, so it is played at most once per tick. Destroyed blocks
+// get the destroy sound; every other contact gets the hit sound.
+void GameplaySystems::playSounds(const GameplayEventQueue& events) {
+    bool hit = false;
+    bool destroy = false;
+    for (const auto& event : events) {
+        if (event.type == GameplayEventType::BlockDestroyed) {
+            destroy = true;
+        }
+        else {
+            hit = true;
+        }
+    }
+    if (hit) {
+        audioManager.playHitSound();
+    }
+    if (destroy) {
+        audioManager.playDestroySound();
+    }
+}
+
+void GameplaySystems::applyBonusEffects(const GameplayEventQueue& events, GameObjectManager& manager) {
+    for (const auto& event : events) {
+        if (event.type != GameplayEventType::BonusCollected) continue;
+        switch (event.bonusType) {
+        case BonusType::ExtendPaddle:
+            manager.getPaddle()->extend();
+            break;
+        case BonusType::SpeedUp:
+            for (auto ball : manager.getBalls()) {
+                ball->increaseSpeed(1.2f);
+            }
+            break;
+        case BonusType::MultiBall:
+            break; // Spawned by spawnObjects
+        }
+    }
+}
+
+void GameplaySystems::spawnObjects(const GameplayEventQueue& events, GameObjectManager& manager) {
+    for (const auto& event : events) {
+        if (event.type == GameplayEventType::BlockDestroyed && event.fromBonusBlock) {
+            // Drawn in event order, so drops stay deterministic for a given seed
+            BonusType type = static_cast<BonusType>(random.uniformInt(0, 2));
+            manager.spawnBonus(event.bounds.left + event.bounds.width / 2, event.bounds.top + event.bounds.height, type);
+        }
+        else if (event.type == GameplayEventType::BonusCollected && event.bonusType == BonusType::MultiBall) {
+            const auto& balls = manager.getBalls();
+            if (!balls.empty()) {
+                auto ball = balls[0];
+                manager.spawnBonusBall(ball->getBounds().left + 10.0f, ball->getBounds().top, ball->getSpeed());
+            }
+        }
+    }
+}
+
+// Counted per tick, so a busy stress level cannot push everything else out of the ring
+void GameplaySystems::recordTelemetry(const GameplayEventQueue& events) {
+    int paddleContacts = 0;
+    int blockHits = 0;
+    int blocksDestroyed = 0;
+    int bonusesCollected = 0;
+    for (const auto& event : events) {
+        switch (event.type) {
+        case GameplayEventType::PaddleContact:
+            ++paddleContacts;
+            break;
+        case GameplayEventType::BlockHit:
+            ++blockHits;
+            break;
+        case GameplayEventType::BlockDestroyed:
+            ++blocksDestroyed;
+            break;
+        case GameplayEventType::BonusCollected:
+            ++bonusesCollected;
+            break;
+        }
+    }
+    if (paddleContacts + blockHits + blocksDestroyed + bonusesCollected > 0) {
+        recordCollisions(paddleContacts, blockHits, blocksDestroyed, bonusesCollected);
+    }
+}
@@ -0,0 +1,22 @@
+export module gameplay_systems;
+
+import gameplay_events;
+import game_object_manager;
+import audio;
+import random_service;
+
+// Applies the side effects of one tick's gameplay events in batches, one system at a time
+export class GameplaySystems {
+public:
+    GameplaySystems(AudioManager& audio, Xoshiro256& random);
+    void process(const GameplayEventQueue& events, GameObjectManager& manager);
+private:
+    AudioManager& audioManager;
+    Xoshiro256& random;
+
+    void applyScore(const GameplayEventQueue& events, GameObjectManager& manager);
+    void playSounds(const GameplayEventQueue& events);
+    void applyBonusEffects(const GameplayEventQueue& events, GameObjectManager& manager);
+    void spawnObjects(const GameplayEventQueue& events, GameObjectManager& manager);
+    void recordTelemetry(const GameplayEventQueue& events);
+};
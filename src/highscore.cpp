@@ -1,19 +1,40 @@
 module highscore;
 
 import <algorithm>;
-import <fstream>;
-import <sstream>;
+import <iostream>;
 import <stdexcept>;
+import <unordered_map>;
+import <utility>;
 import playing_state;
+import durable_file;
+import leaderboard_file;
+import player_history;
+import player_store;
+import trace;
 
-HighScoreManager::HighScoreManager() {
-    std::filesystem::create_directory(playersDir);
+namespace {
+    void sortAndTrim(std::vector<std::pair<std::string, int>>& scores) {
+        std::sort(scores.begin(), scores.end(),
+            [](const auto& a, const auto& b) { return a.second > b.second; });
+        if (scores.size() > 10) {
+            scores.resize(10);
+        }
+    }
+}
+
+HighScoreManager::HighScoreManager(const HighScoreStorage& storage)
+    : storage(storage) {
+    std::filesystem::create_directory(storage.playersDirectory);
     loadHighScores();
+    writer = std::jthread([this](std::stop_token stopToken) {
+        nameTraceThread("HighScoreWriter");
+        writeLoop(stopToken);
+    });
 }
 
 void HighScoreManager::addScore(const std::string& nickname, int score, int currentlevel) {
-    addPlayerScore(nickname, score, currentlevel);
-
+    TraceScope scope("AddScore", "io");
+    auto previous = highScores;
     auto it = std::find_if(highScores.begin(), highScores.end(),
         [&nickname](const auto& entry) { return entry.first == nickname; });
 
@@ -25,90 +46,254 @@ void HighScoreManager::addScore(const std::string& nickname, int score, int curr
     else {
         highScores.emplace_back(nickname, score);
     }
+    sortAndTrim(highScores);
+    players.add(nickname);
+    auto [best, firstScore] = playerBests.try_emplace(nickname, score);
+    bool newBest = firstScore || score > best->second;
+    best->second = std::max(best->second, score);
 
-    std::sort(highScores.begin(), highScores.end(),
-        [](const auto& a, const auto& b) { return a.second > b.second; });
-    if (highScores.size() > 10) {
-        highScores.resize(10);
+    {
+        std::scoped_lock lock(writeMutex);
+        pending.playerLines.emplace_back(nickname, playerHistoryLine(currentlevel, score));
+        if (newBest) {
+            pending.indexLines.emplace_back(nickname, playerIndexLine(nickname, score));
+        }
+        if (highScores != previous) {
+            pending.leaderboard = serializeLeaderboard(highScores);
+            pending.leaderboardChanged = true;
+        }
+        ++queuedScores;
     }
-
-    saveHighScores();
+    writeRequested.notify_one();
 }
 
 bool HighScoreManager::isNicknameUnique(const std::string& nickname) const {
-    return !std::filesystem::exists(playersDir + "/" + nickname + ".txt");
+    return !players.contains(nickname);
+}
+
+const PlayerRegistry& HighScoreManager::getPlayerRegistry() const {
+    return players;
 }
 
 std::vector<std::pair<std::string, int>> HighScoreManager::getHighScores() const {
     return highScores;
 }
 
+void HighScoreManager::flush() {
+    std::unique_lock lock(writeMutex);
+    flushTarget = queuedScores;
+    writeRequested.notify_one();
+    writeFinished.wait(lock, [this] { return attemptedScores >= flushTarget; });
+}
+
 void HighScoreManager::loadHighScores() {
+    TraceScope scope("LoadHighScores", "io");
     highScores.clear();
-    for (const auto& entry : std::filesystem::directory_iterator(playersDir)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".txt") {
-            std::string nickname = entry.path().stem().string();
-            auto scores = loadPlayerScores(nickname);
-            if (!scores.empty()) {
-                int maxScore = *std::max_element(scores.begin(), scores.end());
-                highScores.emplace_back(nickname, maxScore);
-            }
+    PlayerIndex index = readPlayerIndex(storage.playersDirectory);
+    if (!index.found || index.damagedLines > 0) {
+        // First start with this layout, or the index was lost or torn: visit every player once,
+        // since a torn line may have been the only one for its player
+        if (index.found) {
+            std::cerr << "Player index has " << index.damagedLines << " damaged lines, rebuilding it\n";
+        }
+        migrateFlatPlayers(storage.playersDirectory);
+        index.players.clear();
+        for (const auto& nickname : listPlayers(storage.playersDirectory)) {
+            index.players.emplace_back(nickname, loadPlayerHistory(storage.playersDirectory, nickname).bestScore());
+        }
+        std::cout << "Built player index for " << index.players.size() << " players\n";
+    }
+    for (const auto& [nickname, best] : index.players) {
+        players.add(nickname);
+        playerBests.emplace(nickname, best);
+        highScores.emplace_back(nickname, best);
+    }
+    // Rewritten when missing or when repeated bests make up most of it
+    if (!index.found || index.damagedLines > 0 || index.lines > 2 * index.players.size() + 16) {
+        pending.indexRewrite = serializePlayerIndex(index.players);
+        ++queuedScores;
+    }
+
+    // Newest first: a complete .tmp means the process stopped between writing and renaming it
+    const std::string& path = storage.leaderboardFile;
+    LeaderboardCopy leaderboard;
+    std::string source;
+    for (const std::string& candidate : { path + ".tmp", path, path + ".bak" }) {
+        LeaderboardCopy copy = readLeaderboardFile(candidate);
+        if (copy.found && copy.complete) {
+            leaderboard = std::move(copy);
+            source = candidate;
+            break;
         }
     }
+    if (source.empty()) {
+        // No complete copy anywhere; the checksums still tell which records survived
+        leaderboard = readLeaderboardFile(path);
+        source = path;
+        if (leaderboard.found) {
+            std::cerr << "Leaderboard " << path << " is damaged, kept " << leaderboard.records.size() << " intact records\n";
+        }
+    }
+    else if (source != path) {
+        std::cerr << "Recovered leaderboard from " << source << "\n";
+    }
 
-    std::ifstream file(highScoreFile);
-    if (file.is_open()) {
-        std::string line;
-        while (std::getline(file, line)) {
-            std::istringstream iss(line);
-            std::string nickname;
-            int score;
-            if (iss >> nickname >> score) {
-                auto it = std::find_if(highScores.begin(), highScores.end(),
-                    [&nickname](const auto& entry) { return entry.first == nickname; });
-                if (it == highScores.end()) {
-                    highScores.emplace_back(nickname, score);
-                }
-                else if (score > it->second) {
-                    it->second = score;
-                }
-            }
+    for (const auto& [nickname, score] : leaderboard.records) {
+        auto it = std::find_if(highScores.begin(), highScores.end(),
+            [&nickname](const auto& entry) { return entry.first == nickname; });
+        if (it == highScores.end()) {
+            highScores.emplace_back(nickname, score);
+        }
+        else if (score > it->second) {
+            it->second = score;
         }
     }
+    sortAndTrim(highScores);
 
-    std::sort(highScores.begin(), highScores.end(),
-        [](const auto& a, const auto& b) { return a.second > b.second; });
-    if (highScores.size() > 10) {
-        highScores.resize(10);
+    // Put the recovered state back in place; the writer starts with it
+    if (leaderboard.found && (source != path || !leaderboard.complete)) {
+        pending.leaderboard = serializeLeaderboard(highScores);
+        pending.leaderboardChanged = true;
+        ++queuedScores;
     }
 }
 
-void HighScoreManager::saveHighScores() const {
-    std::ofstream file(highScoreFile);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open highscores file for writing: " + highScoreFile);
-    }
-    for (const auto& entry : highScores) {
-        file << entry.first << " " << entry.second << "\n";
+// Waits for scores, gives later ones the batch window to join them, then writes the whole
+// batch with one append per player file, one leaderboard replacement and one sync each.
+// Whatever fails goes back in front of the queue and is retried after storage.retryDelay
+void HighScoreManager::writeLoop(std::stop_token stopToken) {
+    std::unique_lock lock(writeMutex);
+    while (true) {
+        if (!writeRequested.wait(lock, stopToken, [this] { return queuedScores != writtenScores; })) {
+            return; // Stopping with nothing left to write
+        }
+        if (!stopToken.stop_requested() && flushTarget <= attemptedScores) {
+            writeRequested.wait_for(lock, stopToken, storage.batchWindow, [this] { return flushTarget > attemptedScores; });
+        }
+        PendingWrites batch = std::exchange(pending, {});
+        std::uint64_t batchStart = writtenScores;
+        std::uint64_t batchEnd = queuedScores;
+        lock.unlock();
+        PendingWrites failed = writeBatch(batch);
+        lock.lock();
+
+        // Each failed player line is one unsaved score; a failed index or leaderboard write
+        // holds back at least one more, so the writer keeps retrying until it lands
+        bool sharedFileFailed = !failed.indexLines.empty() || !failed.indexRewrite.empty() || failed.leaderboardChanged;
+        std::uint64_t unsaved = std::min<std::uint64_t>(batchEnd - batchStart, failed.playerLines.size() + (sharedFileFailed ? 1 : 0));
+        writtenScores = batchEnd - unsaved;
+        attemptedScores = batchEnd;
+        writeFinished.notify_all();
+        if (unsaved == 0) {
+            continue;
+        }
+        if (stopToken.stop_requested()) {
+            std::cerr << "Giving up on " << unsaved << " unsaved high scores\n";
+            return;
+        }
+        requeue(std::move(failed));
+        // Not straight away: a full or read-only disk would otherwise be retried in a busy loop
+        writeRequested.wait_for(lock, stopToken, storage.retryDelay, [] { return false; });
     }
 }
 
-std::vector<int> HighScoreManager::loadPlayerScores(const std::string& nickname) const {
-    std::vector<int> scores;
-    std::ifstream file(playersDir + "/" + nickname + ".txt");
-    if (file.is_open()) {
-        int score;
-        while (file >> score) {
-            scores.push_back(score);
+HighScoreManager::PendingWrites HighScoreManager::writeBatch(const PendingWrites& batch) {
+    TraceScope scope("WriteHighScores", "io");
+    PendingWrites failed;
+    std::unordered_map<std::string, std::string> appends;
+    for (const auto& [nickname, line] : batch.playerLines) {
+        appends[nickname] += line;
+    }
+    std::unordered_map<std::string, bool> appendFailed;
+    for (const auto& [nickname, lines] : appends) {
+        std::filesystem::path tail = playerBasePath(storage.playersDirectory, nickname) + ".txt";
+        try {
+            std::filesystem::create_directories(tail.parent_path());
+            appendToFile(tail.string(), lines, storage.syncWrites);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to save scores for " << nickname << ": " << e.what() << "\n";
+            appendFailed[nickname] = true;
+            continue;
+        }
+        // Compacting here, on the only thread that writes histories, never races an append.
+        // The lines are already saved, so a failure only leaves the history uncompacted
+        try {
+            if (storage.compactionThreshold > 0 && std::filesystem::file_size(tail) >= storage.compactionThreshold) {
+                compactPlayerHistory(storage.playersDirectory, nickname, storage.compactionThreshold);
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to compact the history of " << nickname << ": " << e.what() << "\n";
         }
     }
-    return scores;
+    for (const auto& entry : batch.playerLines) {
+        if (appendFailed.contains(entry.first)) {
+            failed.playerLines.push_back(entry);
+        }
+    }
+
+    // After the histories, so the index never names a player whose file is missing
+    std::string indexPath = playerIndexPath(storage.playersDirectory);
+    bool indexWritten = true;
+    if (!batch.indexRewrite.empty()) {
+        try {
+            writeFileAtomically(indexPath, batch.indexRewrite, storage.syncWrites);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to rewrite the player index: " << e.what() << "\n";
+            failed.indexRewrite = batch.indexRewrite;
+            indexWritten = false; // New lines must not land on the stale index the rewrite replaces
+        }
+    }
+    std::string indexLines;
+    for (const auto& entry : batch.indexLines) {
+        if (!indexWritten || appendFailed.contains(entry.first)) {
+            failed.indexLines.push_back(entry);
+        }
+        else {
+            indexLines += entry.second;
+        }
+    }
+    if (!indexLines.empty()) {
+        try {
+            appendToFile(indexPath, indexLines, storage.syncWrites);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to update the player index: " << e.what() << "\n";
+            for (const auto& entry : batch.indexLines) {
+                if (!appendFailed.contains(entry.first)) {
+                    failed.indexLines.push_back(entry);
+                }
+            }
+        }
+    }
+
+    if (batch.leaderboardChanged) {
+        try {
+            writeFileAtomically(storage.leaderboardFile, batch.leaderboard, storage.syncWrites);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to save high scores: " << e.what() << "\n";
+            failed.leaderboard = batch.leaderboard;
+            failed.leaderboardChanged = true;
+        }
+    }
+    return failed;
 }
 
-void HighScoreManager::addPlayerScore(const std::string& nickname, int score, int currentlevel) {  
-   std::ofstream file(playersDir + "/" + nickname + ".txt", std::ios::app);  
-   if (!file.is_open()) {  
-       throw std::runtime_error("Failed to open player score file for writing: " + nickname);  
-   }  
-   file<< "Level " << currentlevel << ": " << score << "\n";
-}
\ No newline at end of file
+// Called with writeMutex held. Failed writes are older than anything queued since, so they go
+// first; a newer leaderboard or index rewrite supersedes the failed one
+void HighScoreManager::requeue(PendingWrites&& failed) {
+    pending.playerLines.insert(pending.playerLines.begin(),
+        std::make_move_iterator(failed.playerLines.begin()), std::make_move_iterator(failed.playerLines.end()));
+    pending.indexLines.insert(pending.indexLines.begin(),
+        std::make_move_iterator(failed.indexLines.begin()), std::make_move_iterator(failed.indexLines.end()));
+    if (pending.indexRewrite.empty()) {
+        pending.indexRewrite = std::move(failed.indexRewrite);
+    }
+    if (!pending.leaderboardChanged && failed.leaderboardChanged) {
+        pending.leaderboard = std::move(failed.leaderboard);
+        pending.leaderboardChanged = true;
+    }
+}
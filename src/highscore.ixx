@@ -3,21 +3,68 @@ export module highscore;
 import <vector>;
 import <string>;
 import <filesystem>;
+import <chrono>;
+import <condition_variable>;
+import <cstdint>;
+import <mutex>;
+import <unordered_map>;
+import <thread>;
 import game_state_manager;
+import player_registry;
 
+export struct HighScoreStorage {
+    std::string leaderboardFile = "assets/highscores.txt";
+    std::string playersDirectory = "players";
+    bool syncWrites = true; // Every batch reaches the disk before it counts as written
+    std::chrono::milliseconds batchWindow{ 50 }; // Scores arriving this close together share one write
+    std::chrono::milliseconds retryDelay{ 1000 }; // Pause before writing again after a failed write
+    // A player's history is folded into its summary once the tail grows past this many bytes;
+    // 0 disables compaction
+    std::uintmax_t compactionThreshold = 4096;
+};
+
+// Scores are applied in memory immediately and written by a background thread, so adding a
+// score never waits for the disk. The leaderboard is replaced atomically (see durable_file)
+// and every record carries a checksum (see leaderboard_file); on startup the newest complete
+// copy is used.
 export class HighScoreManager {
 public:
-    HighScoreManager();
+    explicit HighScoreManager(const HighScoreStorage& storage = {});
     void addScore(const std::string& nickname, int score,int currentlevel);
     bool isNicknameUnique(const std::string& nickname) const;
+    // Every player with a history, including ones whose first score is still being written
+    const PlayerRegistry& getPlayerRegistry() const;
     std::vector<std::pair<std::string, int>> getHighScores() const;
+    // Blocks until every score added so far is written, or has failed to write once (failed
+    // writes stay queued and are retried)
+    void flush();
 private:
+    HighScoreStorage storage;
     std::vector<std::pair<std::string, int>> highScores;
-    const std::string highScoreFile = "assets/highscores.txt";
-    const std::string playersDir = "players";
+    PlayerRegistry players;
+    std::unordered_map<std::string, int> playerBests; // Every player's best, as in the player index
+
+    // Everything queued since the writer took the last batch
+    struct PendingWrites {
+        std::vector<std::pair<std::string, std::string>> playerLines; // Nickname, line to append
+        std::vector<std::pair<std::string, std::string>> indexLines; // Nickname, line to append to the player index
+        std::string indexRewrite; // Replaces the player index when not empty; written first
+        std::string leaderboard; // Only the latest version matters
+        bool leaderboardChanged = false;
+    };
+    std::mutex writeMutex;
+    std::condition_variable_any writeRequested;
+    std::condition_variable writeFinished;
+    PendingWrites pending;
+    std::uint64_t queuedScores = 0;
+    std::uint64_t writtenScores = 0;
+    std::uint64_t attemptedScores = 0; // Queued scores the writer has tried to write at least once
+    std::uint64_t flushTarget = 0;
+    std::jthread writer; // Declared last so it stops before the queue goes away
 
     void loadHighScores();
-    void saveHighScores() const;
-    std::vector<int> loadPlayerScores(const std::string& nickname) const;
-    void addPlayerScore(const std::string& nickname, int score, int currentlevel);
-};
\ No newline at end of file
+    void writeLoop(std::stop_token stopToken);
+    // Returns what could not be written; every file is attempted even when another one fails
+    PendingWrites writeBatch(const PendingWrites& batch);
+    void requeue(PendingWrites&& failed);
+};
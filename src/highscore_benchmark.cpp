@@ -0,0 +1,124 @@
+module highscore_benchmark;
+
+import <algorithm>;
+import <chrono>;
+import <filesystem>;
+import <fstream>;
+import <iomanip>;
+import <iostream>;
+import <string>;
+import <vector>;
+import highscore;
+
+namespace {
+    constexpr int benchmarkPlayers = 25;
+
+    struct BenchmarkResult {
+        double p50Microseconds = 0.0;
+        double p99Microseconds = 0.0;
+        double maxMicroseconds = 0.0;
+        double totalMilliseconds = 0.0; // Until the last score is on disk
+    };
+
+    HighScoreStorage scratchStorage(const std::filesystem::path& directory, bool sync, std::chrono::milliseconds batchWindow) {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        HighScoreStorage storage;
+        storage.leaderboardFile = (directory / "highscores.txt").string();
+        storage.playersDirectory = (directory / "players").string();
+        storage.syncWrites = sync;
+        storage.batchWindow = batchWindow;
+        return storage;
+    }
+
+    // flushEach waits for every score to reach the disk, like the old synchronous writes did
+    BenchmarkResult runMode(const HighScoreStorage& storage, int scoreCount, bool flushEach) {
+        HighScoreManager manager(storage);
+        std::vector<double> latencies;
+        latencies.reserve(scoreCount);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < scoreCount; ++i) {
+            auto scoreStart = std::chrono::steady_clock::now();
+            manager.addScore("player" + std::to_string(i % benchmarkPlayers), (i * 7919) % 100000, i % 10 + 1);
+            if (flushEach) {
+                manager.flush();
+            }
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - scoreStart).count());
+        }
+        manager.flush();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        std::sort(latencies.begin(), latencies.end());
+        BenchmarkResult result;
+        result.p50Microseconds = latencies[latencies.size() / 2];
+        result.p99Microseconds = latencies[latencies.size() * 99 / 100];
+        result.maxMicroseconds = latencies.back();
+        result.totalMilliseconds = std::chrono::duration<double, std::milli>(elapsed).count();
+        return result;
+    }
+
+    // Truncates the leaderboard halfway through a record, as a crash during a non-atomic write
+    // would, and checks that the previous complete version is loaded and put back
+    bool checkRecovery(const std::filesystem::path& directory) {
+        HighScoreStorage storage = scratchStorage(directory, false, std::chrono::milliseconds(0));
+        std::vector<std::pair<std::string, int>> expected;
+        {
+            HighScoreManager manager(storage);
+            for (int i = 0; i < 5; ++i) {
+                manager.addScore("player" + std::to_string(i), 1000 * (i + 1), 1);
+                manager.flush();
+            }
+            expected = manager.getHighScores();
+            manager.addScore("latest", 10, 1);
+            manager.flush();
+        }
+        std::filesystem::remove_all(storage.playersDirectory);
+        auto size = std::filesystem::file_size(storage.leaderboardFile);
+        std::filesystem::resize_file(storage.leaderboardFile, size / 2);
+
+        HighScoreManager recovered(storage);
+        recovered.flush();
+        if (recovered.getHighScores() != expected) {
+            return false;
+        }
+        // The repaired file must now load on its own
+        std::filesystem::remove(storage.leaderboardFile + ".bak");
+        HighScoreManager reloaded(storage);
+        return reloaded.getHighScores() == expected;
+    }
+}
+
+int runHighScoreBenchmark(int scoreCount) {
+    if (scoreCount == 0) {
+        scoreCount = 1;
+    }
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "arkanoid_highscore_benchmark";
+    std::cout << "High score benchmark: " << scoreCount << " scores, " << benchmarkPlayers << " players\n";
+    std::cout << "mode                 p50 us    p99 us    max us  total ms\n";
+
+    struct Mode {
+        const char* name;
+        bool sync;
+        bool flushEach;
+    };
+    const Mode modes[] = {
+        { "sync every score", true, true },
+        { "sync batched", true, false },
+        { "no sync, batched", false, false },
+    };
+    for (const Mode& mode : modes) {
+        HighScoreStorage storage = scratchStorage(directory, mode.sync, HighScoreStorage{}.batchWindow);
+        BenchmarkResult result = runMode(storage, scoreCount, mode.flushEach);
+        std::cout << std::left << std::setw(17) << mode.name << std::right
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << result.p50Microseconds
+            << std::setw(10) << result.p99Microseconds
+            << std::setw(10) << result.maxMicroseconds
+            << std::setw(10) << result.totalMilliseconds << "\n";
+    }
+
+    bool recovered = checkRecovery(directory);
+    std::filesystem::remove_all(directory);
+    std::cout << (recovered ? "Damaged leaderboard recovered from backup\n" : "ERROR: damaged leaderboard was not recovered\n");
+    return recovered ? 0 : 1;
+}
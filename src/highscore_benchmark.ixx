@@ -0,0 +1,6 @@
+export module highscore_benchmark;
+
+// Headless high score persistence run in a scratch directory: adds scores one after another
+// with per-score syncing, batched syncing and no syncing, and reports how long addScore keeps
+// the caller waiting. Afterwards damages the saved leaderboard and checks that it recovers.
+export int runHighScoreBenchmark(int scoreCount);
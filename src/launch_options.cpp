@@ -0,0 +1,136 @@
+module launch_options;
+
+import <iostream>;
+import <stdexcept>;
+import <thread>;
+import <sstream>;
+import <cstdint>;
+
+namespace {
+    std::string readValue(int argc, char* argv[], int& i) {
+        if (i + 1 >= argc) {
+            throw std::runtime_error(std::string("Missing value for option: ") + argv[i]);
+        }
+        return argv[++i];
+    }
+
+    int readCount(int argc, char* argv[], int& i) {
+        int value = std::stoi(readValue(argc, argv, i));
+        if (value < 0) {
+            throw std::runtime_error(std::string("Negative value for option: ") + argv[i - 1]);
+        }
+        return value;
+    }
+}
+
+LaunchOptions parseLaunchOptions(int argc, char* argv[]) {
+    LaunchOptions options;
+    unsigned cores = std::thread::hardware_concurrency();
+    options.workerThreads = cores > 1 ? cores - 1 : 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threaded-sim") {
+            options.threadedSimulation = true;
+        }
+        else if (arg == "--threads") {
+            int threads = readCount(argc, argv, i);
+            options.workerThreads = threads > 0 ? threads - 1 : 0;
+        }
+        else if (arg == "--stress-balls") {
+            options.stressBalls = readCount(argc, argv, i);
+        }
+        else if (arg == "--bench-balls") {
+            options.benchBalls = readCount(argc, argv, i);
+        }
+        else if (arg == "--bench-highscores") {
+            options.benchHighScores = readCount(argc, argv, i);
+        }
+        else if (arg == "--no-highscore-sync") {
+            options.highScoreSync = false;
+        }
+        else if (arg == "--generate") {
+            std::string size = readValue(argc, argv, i);
+            size_t separator = size.find('x');
+            if (separator == std::string::npos) {
+                throw std::runtime_error("Level size must look like ROWSxCOLUMNS: " + size);
+            }
+            options.generateLevel = true;
+            options.generator.rows = std::stoi(size.substr(0, separator));
+            options.generator.columns = std::stoi(size.substr(separator + 1));
+        }
+        else if (arg == "--density") {
+            options.generator.density = std::stof(readValue(argc, argv, i));
+        }
+        else if (arg == "--seed") {
+            options.seed = std::stoull(readValue(argc, argv, i));
+            options.generator.seed = *options.seed;
+        }
+        else if (arg == "--mix") {
+            std::string mix = readValue(argc, argv, i);
+            char colon1 = 0, colon2 = 0;
+            std::istringstream iss(mix);
+            if (!(iss >> options.generator.normalWeight >> colon1 >> options.generator.indestructibleWeight
+                >> colon2 >> options.generator.bonusWeight) || colon1 != ':' || colon2 != ':') {
+                throw std::runtime_error("Block mix must look like NORMAL:INDESTRUCTIBLE:BONUS: " + mix);
+            }
+        }
+        else if (arg == "--output") {
+            options.generatorOutput = readValue(argc, argv, i);
+        }
+        else if (arg == "--embedded-levels") {
+            options.embeddedLevels = true;
+        }
+        else if (arg == "--trace") {
+            options.tracePath = readValue(argc, argv, i);
+        }
+        else if (arg == "--hitch-ms") {
+            options.hitchMilliseconds = std::stof(readValue(argc, argv, i));
+        }
+        else if (arg == "--flight-log") {
+            options.flightLogPath = readValue(argc, argv, i);
+        }
+        else if (arg == "--alloc-report") {
+            options.allocationReport = true;
+        }
+        else if (arg == "--alloc-assert") {
+            options.allocationAssertions = true;
+        }
+        else if (arg == "--watch-levels") {
+            options.watchLevels = true;
+        }
+        else if (arg == "--pack-assets") {
+            options.packAssets = true;
+        }
+        else if (arg == "--asset-pack") {
+            options.assetPack = readValue(argc, argv, i);
+        }
+        else if (arg == "--stress-play") {
+            options.stressPlay = true;
+        }
+        else if (arg == "--endless") {
+            options.endless = true;
+        }
+        else if (arg == "--pack-levels") {
+            options.levelPackOutput = readValue(argc, argv, i);
+        }
+        else if (arg == "--compact-players") {
+            options.compactPlayers = true;
+        }
+        else if (arg == "--fps") {
+            options.pacing = parsePacingOptions(readValue(argc, argv, i));
+        }
+        else if (arg == "--frame-stats") {
+            options.frameStats = true;
+        }
+        else if (arg == "--pacer-selftest") {
+            options.pacerSelfTest = true;
+        }
+        else if (arg == "--alloc-selftest") {
+            options.allocationSelfTest = true;
+        }
+        else {
+            std::cerr << "Warning: Unknown option '" << arg << "' ignored\n";
+        }
+    }
+    return options;
+}
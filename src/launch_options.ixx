@@ -0,0 +1,39 @@
+export module launch_options;
+
+import <string>;
+import <cstdint>;
+import <optional>;
+import level_generator;
+import frame_pacer;
+
+export struct LaunchOptions {
+    bool threadedSimulation = false;
+    unsigned workerThreads = 0;   // Extra threads for ball physics, in addition to the simulating thread
+    int stressBalls = 0;          // Extra balls spawned at the start of every level
+    int benchBalls = 0;           // Run the headless ball physics benchmark instead of the game
+    int benchHighScores = 0;      // Run the headless high score persistence benchmark instead of the game
+    bool highScoreSync = true;    // Sync high score writes to disk
+    bool generateLevel = false;
+    LevelGeneratorParams generator;
+    std::string generatorOutput;  // Write the generated level here
+    bool stressPlay = false;      // Play the generated level (or level 1) directly and report frame times
+    bool endless = false;         // Stress play runs endless mode instead of a fixed layout
+    bool embeddedLevels = false;  // Use the campaign compiled into the executable
+    std::optional<std::uint64_t> seed;  // Session seed; random when not given
+    std::string tracePath;        // Write a Chrome trace of the session here
+    float hitchMilliseconds = 100.0f; // Dump the flight recorder for frames slower than this; 0 disables
+    std::string flightLogPath = "flight_recorder.log";
+    bool allocationReport = false;     // Print allocations per frame and per zone every few seconds
+    bool allocationAssertions = false; // Abort when a zero-allocation zone allocates
+    bool watchLevels = false;     // Hot-reload level files edited while playing
+    bool packAssets = false;      // Build the asset pack from assets/ and exit
+    std::string assetPack = "assets.pak";
+    std::string levelPackOutput;  // Pack the loose campaign levels into this file and exit
+    bool compactPlayers = false;  // Fold every player's history into its summary and exit
+    std::optional<PacingOptions> pacing; // 120 Hz, or uncapped for stress play, when not given
+    bool frameStats = false;      // Print frame time statistics on exit
+    bool pacerSelfTest = false;   // Run the headless frame pacing test instead of the game
+    bool allocationSelfTest = false; // Run the headless zero-allocation test instead of the game
+};
+
+export LaunchOptions parseLaunchOptions(int argc, char* argv[]);
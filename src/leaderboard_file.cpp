@@ -0,0 +1,68 @@
+module leaderboard_file;
+
+import <charconv>;
+import <cstdint>;
+import <cstdio>;
+import <fstream>;
+import <sstream>;
+import durable_file;
+
+namespace {
+    const std::string leaderboardHeader = "# highscores v2";
+    const std::string leaderboardEnd = "# end ";
+
+    std::string leaderboardRecord(const std::string& nickname, int score) {
+        return nickname + " " + std::to_string(score);
+    }
+}
+
+LeaderboardCopy readLeaderboardFile(const std::string& path) {
+    LeaderboardCopy copy;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return copy;
+    }
+    copy.found = true;
+    bool versioned = false;
+    bool ended = false;
+    size_t expectedRecords = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        if (line == leaderboardHeader) {
+            versioned = true;
+            continue;
+        }
+        if (line.starts_with(leaderboardEnd)) {
+            auto digits = line.data() + leaderboardEnd.size();
+            ended = std::from_chars(digits, line.data() + line.size(), expectedRecords).ec == std::errc();
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string nickname;
+        int score = 0;
+        std::uint32_t checksum = 0;
+        if (!(iss >> nickname >> score)
+            || (versioned && (!(iss >> std::hex >> checksum) || checksum != recordChecksum(leaderboardRecord(nickname, score))))) {
+            ++copy.damagedRecords;
+            continue;
+        }
+        copy.records.emplace_back(nickname, score);
+    }
+    copy.complete = copy.damagedRecords == 0 && (!versioned || (ended && expectedRecords == copy.records.size()));
+    return copy;
+}
+
+std::string serializeLeaderboard(const std::vector<std::pair<std::string, int>>& entries) {
+    std::string text = leaderboardHeader + "\n";
+    for (const auto& [nickname, score] : entries) {
+        std::string record = leaderboardRecord(nickname, score);
+        char checksum[16];
+        std::snprintf(checksum, sizeof(checksum), " %08x\n", recordChecksum(record));
+        text += record;
+        text += checksum;
+    }
+    text += leaderboardEnd + std::to_string(entries.size()) + "\n";
+    return text;
+}
@@ -0,0 +1,20 @@
+export module leaderboard_file;
+
+import <string>;
+import <utility>;
+import <vector>;
+
+// Leaderboard text format, shared by the game and the offline rebuild tool. Version 2 lines
+// are "nickname score checksum" (8 hex digits of recordChecksum("nickname score")), between a
+// "# highscores v2" header and an "# end N" marker holding the record count. Older files have
+// neither and are taken as they are.
+
+export struct LeaderboardCopy {
+    bool found = false;
+    bool complete = false; // Every record checks out and the end marker matches
+    std::vector<std::pair<std::string, int>> records;
+    int damagedRecords = 0;
+};
+
+export LeaderboardCopy readLeaderboardFile(const std::string& path);
+export std::string serializeLeaderboard(const std::vector<std::pair<std::string, int>>& entries);
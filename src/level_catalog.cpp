@@ -0,0 +1,391 @@
+module level_catalog;
+
+import <algorithm>;
+import <array>;
+import <cstring>;
+import <filesystem>;
+import <fstream>;
+import <iostream>;
+import <span>;
+import <stdexcept>;
+import <string_view>;
+import asset_pack;
+import durable_file;
+import embedded_levels;
+import trace;
+
+namespace {
+    constexpr std::array<char, 8> levelPackMagic = { 'A', 'R', 'K', 'L', 'V', 'L', 'S', '1' };
+    constexpr std::size_t headerSize = levelPackMagic.size() + 2 * sizeof(std::uint32_t);
+    const std::string packDirectory = "assets/levels/";
+    const std::string packExtension = ".lvlpack";
+
+    template<typename T>
+    T readInteger(std::string_view data, std::size_t& pos) {
+        if (pos + sizeof(T) > data.size()) {
+            throw std::runtime_error("Level pack index is truncated");
+        }
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(static_cast<std::uint8_t>(data[pos + i])) << (8 * i);
+        }
+        pos += sizeof(T);
+        return value;
+    }
+
+    template<typename T>
+    void appendInteger(std::string& out, T value) {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    std::string readWholeFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open level file: " + path);
+        }
+        std::string data(static_cast<std::size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        return data;
+    }
+
+    std::string readPackRange(const std::string& path, std::uint64_t offset, std::size_t size) {
+        auto packed = findAsset(path);
+        if (!packed.empty()) {
+            if (offset > packed.size() || size > packed.size() - offset) {
+                throw std::runtime_error("Level pack read out of range: " + path);
+            }
+            return std::string(reinterpret_cast<const char*>(packed.data() + offset), size);
+        }
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open level pack: " + path);
+        }
+        std::string data(size, '\0');
+        file.seekg(static_cast<std::streamoff>(offset));
+        if (!file.read(data.data(), static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Level pack read out of range: " + path);
+        }
+        return data;
+    }
+
+    LevelConfig embeddedLevelConfig(const EmbeddedLevel& level) {
+        LevelConfig config;
+        config.paddleWidth = level.paddleWidth;
+        config.ballSpeed = level.ballSpeed;
+        config.layout.rows = level.rows;
+        config.layout.columns = level.columns;
+        config.layout.cells.reserve(level.rows * level.columns);
+        for (std::size_t row = 0; row < level.rows; ++row) {
+            for (char c : level.row(row)) {
+                config.layout.cells.push_back({ static_cast<CellType>(c - '0') });
+            }
+        }
+        return config;
+    }
+
+    // Number of assets/levelN.txt, or 0 for any other path
+    int looseLevelNumber(std::string_view path) {
+        constexpr std::string_view prefix = "assets/level";
+        constexpr std::string_view suffix = ".txt";
+        if (!path.starts_with(prefix) || !path.ends_with(suffix)) {
+            return 0;
+        }
+        std::string_view digits = path.substr(prefix.size(), path.size() - prefix.size() - suffix.size());
+        if (digits.empty() || digits.size() > 6 || !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return 0;
+        }
+        int number = 0;
+        for (char c : digits) {
+            number = number * 10 + (c - '0');
+        }
+        return number;
+    }
+
+    // Loose and asset-pack level files in level number order; gaps in the numbering are skipped
+    std::vector<std::string> looseLevelFiles() {
+        std::vector<std::pair<int, std::string>> numbered;
+        auto addFile = [&numbered](const std::string& path) {
+            if (int number = looseLevelNumber(path); number > 0) {
+                numbered.emplace_back(number, path);
+            }
+        };
+        for (const auto& path : listPackedAssets("assets/level")) {
+            addFile(path);
+        }
+        std::error_code error;
+        for (const auto& item : std::filesystem::directory_iterator("assets", error)) {
+            if (item.is_regular_file()) {
+                addFile("assets/" + item.path().filename().string());
+            }
+        }
+        std::sort(numbered.begin(), numbered.end());
+        numbered.erase(std::unique(numbered.begin(), numbered.end()), numbered.end());
+        std::vector<std::string> files;
+        files.reserve(numbered.size());
+        for (auto& [number, path] : numbered) {
+            files.push_back(std::move(path));
+        }
+        return files;
+    }
+
+    LevelThumbnail decodeThumbnail(std::string_view data) {
+        LevelThumbnail thumbnail;
+        if (data.size() < 2) {
+            throw std::runtime_error("Level thumbnail is truncated");
+        }
+        thumbnail.rows = static_cast<std::uint8_t>(data[0]);
+        thumbnail.columns = static_cast<std::uint8_t>(data[1]);
+        if (data.size() < 2 + thumbnail.rows * thumbnail.columns) {
+            throw std::runtime_error("Level thumbnail is truncated");
+        }
+        thumbnail.cells.reserve(thumbnail.rows * thumbnail.columns);
+        for (char c : data.substr(2, thumbnail.rows * thumbnail.columns)) {
+            thumbnail.cells.push_back(static_cast<CellType>(std::min<std::uint8_t>(static_cast<std::uint8_t>(c), 3)));
+        }
+        return thumbnail;
+    }
+}
+
+void LevelCatalog::scan() {
+    TraceScope scope("ScanLevelCatalog", "io");
+    packs.clear();
+    entries.clear();
+    embedded = false;
+
+    // Packs can be loose files or inside the asset pack
+    std::vector<std::string> packPaths = listPackedAssets(packDirectory);
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(packDirectory, error)) {
+        if (item.is_regular_file()) {
+            packPaths.push_back(packDirectory + item.path().filename().string());
+        }
+    }
+    std::erase_if(packPaths, [](const std::string& path) { return !path.ends_with(packExtension); });
+    std::sort(packPaths.begin(), packPaths.end());
+    packPaths.erase(std::unique(packPaths.begin(), packPaths.end()), packPaths.end());
+    for (const auto& path : packPaths) {
+        try {
+            readPackIndex(path);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Skipping level pack " << path << ": " << e.what() << "\n";
+        }
+    }
+
+    if (packs.empty()) {
+        for (const auto& path : looseLevelFiles()) {
+            LevelCatalogEntry entry;
+            entry.name = "Level " + std::to_string(entries.size() + 1);
+            entry.file = path;
+            entries.push_back(std::move(entry));
+        }
+    }
+    std::cout << "Level catalog: " << entries.size() << " levels in " << packs.size() << " packs\n";
+}
+
+void LevelCatalog::useEmbeddedLevels() {
+    packs.clear();
+    entries.clear();
+    embedded = true;
+    for (std::size_t i = 0; i < embeddedLevels.size(); ++i) {
+        LevelCatalogEntry entry;
+        entry.name = "Level " + std::to_string(i + 1);
+        entries.push_back(std::move(entry));
+    }
+}
+
+// One read each for the header, the index and the thumbnails; level data is only read when played
+void LevelCatalog::readPackIndex(const std::string& path) {
+    std::string header = readPackRange(path, 0, headerSize);
+    if (std::memcmp(header.data(), levelPackMagic.data(), levelPackMagic.size()) != 0) {
+        throw std::runtime_error("Not a level pack");
+    }
+    std::size_t pos = levelPackMagic.size();
+    std::uint32_t count = readInteger<std::uint32_t>(header, pos);
+    std::uint32_t indexSize = readInteger<std::uint32_t>(header, pos);
+    std::string index = readPackRange(path, headerSize, indexSize);
+    int packNumber = static_cast<int>(packs.size());
+
+    std::vector<LevelCatalogEntry> packEntries;
+    packEntries.reserve(count);
+    pos = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        LevelCatalogEntry entry;
+        std::uint16_t nameLength = readInteger<std::uint16_t>(index, pos);
+        if (pos + nameLength > index.size()) {
+            throw std::runtime_error("Level pack index is truncated");
+        }
+        entry.name.assign(index.data() + pos, nameLength);
+        pos += nameLength;
+        entry.difficulty = readInteger<std::uint8_t>(index, pos);
+        entry.checksum = readInteger<std::uint32_t>(index, pos);
+        entry.dataOffset = readInteger<std::uint64_t>(index, pos);
+        entry.dataSize = readInteger<std::uint32_t>(index, pos);
+        entry.thumbnailOffset = readInteger<std::uint64_t>(index, pos);
+        entry.pack = packNumber;
+        packEntries.push_back(std::move(entry));
+    }
+
+    // The writer puts every thumbnail between the index and the first level text
+    std::uint64_t thumbnailsBegin = headerSize + indexSize;
+    std::uint64_t thumbnailsEnd = UINT64_MAX;
+    for (const auto& entry : packEntries) {
+        thumbnailsEnd = std::min(thumbnailsEnd, entry.dataOffset);
+    }
+    if (packEntries.empty() || thumbnailsEnd < thumbnailsBegin) {
+        thumbnailsEnd = thumbnailsBegin;
+    }
+    std::string thumbnails = readPackRange(path, thumbnailsBegin, thumbnailsEnd - thumbnailsBegin);
+    for (auto& entry : packEntries) {
+        if (entry.thumbnailOffset == 0) continue;
+        if (entry.thumbnailOffset < thumbnailsBegin || entry.thumbnailOffset >= thumbnailsEnd) {
+            throw std::runtime_error("Level thumbnail lies outside the thumbnail block");
+        }
+        entry.thumbnail = decodeThumbnail(std::string_view(thumbnails).substr(entry.thumbnailOffset - thumbnailsBegin));
+    }
+    packs.push_back(path);
+    entries.insert(entries.end(), std::make_move_iterator(packEntries.begin()), std::make_move_iterator(packEntries.end()));
+}
+
+int LevelCatalog::count() const {
+    return static_cast<int>(entries.size());
+}
+
+const LevelCatalogEntry& LevelCatalog::entry(int number) const {
+    if (number < 1 || number > count()) {
+        throw std::runtime_error("No level " + std::to_string(number) + " in the catalog");
+    }
+    return entries[number - 1];
+}
+
+LevelConfig LevelCatalog::load(int number) const {
+    TraceScope scope("LoadLevel", "level");
+    const LevelCatalogEntry& level = entry(number);
+    LevelConfig config;
+    if (embedded) {
+        config = embeddedLevelConfig(embeddedLevels[number - 1]);
+    }
+    else if (level.pack < 0) {
+        config = loadLevelConfig(level.file);
+    }
+    else {
+        std::string text = readPackRange(packs[level.pack], level.dataOffset, level.dataSize);
+        if (recordChecksum(text) != level.checksum) {
+            throw std::runtime_error("Checksum mismatch for level \"" + level.name + "\" in " + packs[level.pack]);
+        }
+        config = parseLevelConfig(text, packs[level.pack] + ":" + level.name);
+    }
+    if (config.name.empty()) {
+        config.name = level.name;
+    }
+    return config;
+}
+
+const LevelThumbnail& LevelCatalog::thumbnail(int number) const {
+    return entry(number).thumbnail;
+}
+
+std::string LevelCatalog::filePath(int number) const {
+    const LevelCatalogEntry& level = entry(number);
+    if (embedded || level.file.empty() || !findAsset(level.file).empty()) {
+        return "";
+    }
+    return level.file;
+}
+
+LevelThumbnail makeThumbnail(const LevelGrid& layout, std::size_t maxRows, std::size_t maxColumns) {
+    LevelThumbnail thumbnail;
+    thumbnail.rows = std::min(layout.rows, maxRows);
+    thumbnail.columns = std::min(layout.columns, maxColumns);
+    thumbnail.cells.assign(thumbnail.rows * thumbnail.columns, CellType::Empty);
+    for (std::size_t row = 0; row < layout.rows; ++row) {
+        std::size_t thumbnailRow = row * thumbnail.rows / layout.rows;
+        for (std::size_t column = 0; column < layout.columns; ++column) {
+            CellType& cell = thumbnail.cells[thumbnailRow * thumbnail.columns + column * thumbnail.columns / layout.columns];
+            cell = std::max(cell, layout.at(row, column).type);
+        }
+    }
+    return thumbnail;
+}
+
+int writeLevelPack(const std::vector<std::string>& levelFiles, const std::string& packPath) {
+    if (levelFiles.empty()) {
+        throw std::runtime_error("No levels to pack");
+    }
+    struct PackedLevel {
+        std::string name;
+        int difficulty = 0;
+        std::string text;
+        LevelThumbnail thumbnail;
+    };
+    std::vector<PackedLevel> levels;
+    std::uint64_t indexSize = 0;
+    for (const auto& path : levelFiles) {
+        PackedLevel level;
+        level.text = readWholeFile(path);
+        // Parsing up front means a pack never holds a level the game would reject
+        LevelConfig config;
+        try {
+            config = parseLevelConfig(level.text, path);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Skipping level " << path << ": " << e.what() << "\n";
+            continue;
+        }
+        level.name = !config.name.empty() ? config.name : std::filesystem::path(path).stem().string();
+        level.difficulty = config.difficulty;
+        level.thumbnail = makeThumbnail(config.layout);
+        if (level.name.size() > UINT16_MAX || level.text.size() > UINT32_MAX) {
+            throw std::runtime_error("Level too large to pack: " + path);
+        }
+        indexSize += sizeof(std::uint16_t) + level.name.size() + sizeof(std::uint8_t) + 2 * sizeof(std::uint32_t)
+            + 2 * sizeof(std::uint64_t);
+        levels.push_back(std::move(level));
+    }
+    if (levels.empty()) {
+        throw std::runtime_error("None of the levels could be packed");
+    }
+
+    std::string pack(levelPackMagic.data(), levelPackMagic.size());
+    appendInteger<std::uint32_t>(pack, static_cast<std::uint32_t>(levels.size()));
+    appendInteger<std::uint32_t>(pack, static_cast<std::uint32_t>(indexSize));
+    std::uint64_t thumbnailOffset = headerSize + indexSize;
+    std::uint64_t dataOffset = thumbnailOffset;
+    for (const auto& level : levels) {
+        dataOffset += 2 + level.thumbnail.cells.size();
+    }
+    for (const auto& level : levels) {
+        appendInteger<std::uint16_t>(pack, static_cast<std::uint16_t>(level.name.size()));
+        pack += level.name;
+        appendInteger<std::uint8_t>(pack, static_cast<std::uint8_t>(level.difficulty));
+        appendInteger<std::uint32_t>(pack, recordChecksum(level.text));
+        appendInteger<std::uint64_t>(pack, dataOffset);
+        appendInteger<std::uint32_t>(pack, static_cast<std::uint32_t>(level.text.size()));
+        appendInteger<std::uint64_t>(pack, thumbnailOffset);
+        thumbnailOffset += 2 + level.thumbnail.cells.size();
+        dataOffset += level.text.size();
+    }
+    for (const auto& level : levels) {
+        appendInteger<std::uint8_t>(pack, static_cast<std::uint8_t>(level.thumbnail.rows));
+        appendInteger<std::uint8_t>(pack, static_cast<std::uint8_t>(level.thumbnail.columns));
+        for (CellType cell : level.thumbnail.cells) {
+            pack += static_cast<char>(cell);
+        }
+    }
+    for (const auto& level : levels) {
+        pack += level.text;
+    }
+
+    std::ofstream file(packPath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open level pack for writing: " + packPath);
+    }
+    file.write(pack.data(), static_cast<std::streamsize>(pack.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to write level pack: " + packPath);
+    }
+    return static_cast<int>(levels.size());
+}
@@ -0,0 +1,69 @@
+export module level_catalog;
+
+import <cstddef>;
+import <cstdint>;
+import <string>;
+import <vector>;
+import config;
+
+// Level packs bundle many levels into one file with an index in front, so the menus can list
+// every level from a single read per pack. Layout: "ARKLVLS1", uint32 level count, uint32
+// index size in bytes, then per level a uint16 name length, the name, uint8 difficulty,
+// uint32 checksum (FNV-1a of the level text), uint64 data offset, uint32 data size and uint64
+// thumbnail offset (0 for none), followed by every thumbnail and then the level texts. A
+// thumbnail is uint8 rows, uint8 columns and one CellType byte per cell. Integers are
+// little-endian and offsets are relative to the start of the pack.
+
+export struct LevelThumbnail {
+    std::size_t rows = 0;
+    std::size_t columns = 0;
+    std::vector<CellType> cells; // Row-major
+};
+
+export struct LevelCatalogEntry {
+    std::string name;
+    int difficulty = 0;                // 1 (easiest) to 5, 0 when not rated
+    std::uint32_t checksum = 0;        // 0 for loose and embedded levels, which are not checked
+    std::uint64_t thumbnailOffset = 0;
+    std::uint64_t dataOffset = 0;
+    std::uint32_t dataSize = 0;
+    int pack = -1;                     // Index into the pack list; -1 when not packed
+    std::string file;                  // Loose level file, when there is one
+    LevelThumbnail thumbnail;          // Read with the pack index; empty for loose levels
+};
+
+// Built once at startup and shared by every state; read-only afterwards, so prefetch threads
+// may load levels concurrently
+export class LevelCatalog {
+public:
+    // Reads the index and thumbnails of every pack in assets/levels/, in file name order.
+    // Without packs the loose assets/levelN.txt files form the campaign, ordered by N; gaps
+    // in the numbering are skipped.
+    void scan();
+    // Uses the levels compiled into the executable instead
+    void useEmbeddedLevels();
+
+    int count() const;
+    // Level numbers start at 1
+    const LevelCatalogEntry& entry(int number) const;
+    // Reads one level; packed levels are verified against their checksum
+    LevelConfig load(int number) const;
+    // Empty when the level has no thumbnail; never touches the disk
+    const LevelThumbnail& thumbnail(int number) const;
+    // Loose file that load(number) reads, or an empty string when the level is packed,
+    // embedded or inside the asset pack
+    std::string filePath(int number) const;
+private:
+    std::vector<std::string> packs;
+    std::vector<LevelCatalogEntry> entries;
+    bool embedded = false;
+
+    void readPackIndex(const std::string& path);
+};
+
+// Packs the given level files into one pack, in order. Files that fail to parse are skipped
+// with a warning. Returns the number of packed levels.
+export int writeLevelPack(const std::vector<std::string>& levelFiles, const std::string& packPath);
+// Downsamples a layout to at most maxRows x maxColumns cells; each thumbnail cell takes the
+// highest cell type of the area it covers
+export LevelThumbnail makeThumbnail(const LevelGrid& layout, std::size_t maxRows = 24, std::size_t maxColumns = 32);
@@ -0,0 +1,61 @@
+module level_generator;
+
+import random_service;
+import <algorithm>;
+import <stdexcept>;
+import <iostream>;
+
+LevelConfig generateLevel(const LevelGeneratorParams& params) {
+    if (params.rows < 1 || params.columns < 1 || params.rows > 1000 || params.columns > 1000) {
+        throw std::runtime_error("Generated level must be between 1x1 and 1000x1000 blocks");
+    }
+    if (params.density < 0.0f || params.density > 1.0f) {
+        throw std::runtime_error("Block density must be between 0 and 1");
+    }
+    int totalWeight = params.normalWeight + params.indestructibleWeight + params.bonusWeight;
+    if (params.normalWeight < 0 || params.indestructibleWeight < 0 || params.bonusWeight < 0 || totalWeight <= 0) {
+        throw std::runtime_error("Block-type weights must be non-negative and not all zero");
+    }
+
+    Xoshiro256 gen(params.seed);
+
+    LevelConfig config;
+    config.paddleWidth = params.paddleWidth;
+    config.ballSpeed = params.ballSpeed;
+    LevelGrid& layout = config.layout;
+    layout.rows = params.rows;
+    layout.columns = params.columns;
+    layout.cells.assign(layout.rows * layout.columns, LevelCell{});
+    for (int row = 0; row < params.rows; ++row) {
+        generateRow(gen, params, &layout.at(row, 0));
+    }
+    bool hasDestructible = std::any_of(layout.cells.begin(), layout.cells.end(), [](const LevelCell& cell) {
+        return cell.type == CellType::Normal || cell.type == CellType::Bonus;
+    });
+
+    // A level without destructible blocks would count as completed on the first frame
+    if (!hasDestructible) {
+        layout.at(params.rows / 2, params.columns / 2).type = CellType::Normal;
+    }
+    std::cout << "Generated " << params.rows << "x" << params.columns << " level (seed " << params.seed << ")\n";
+    return config;
+}
+
+void generateRow(Xoshiro256& gen, const LevelGeneratorParams& params, LevelCell* cells) {
+    int totalWeight = params.normalWeight + params.indestructibleWeight + params.bonusWeight;
+    for (int col = 0; col < params.columns; ++col) {
+        LevelCell& cell = cells[col];
+        cell = LevelCell{};
+        if (gen.uniformFloat() >= params.density) continue;
+        int roll = gen.uniformInt(0, totalWeight - 1);
+        if (roll < params.normalWeight) {
+            cell.type = CellType::Normal;
+        }
+        else if (roll < params.normalWeight + params.indestructibleWeight) {
+            cell.type = CellType::Indestructible;
+        }
+        else {
+            cell.type = CellType::Bonus;
+        }
+    }
+}
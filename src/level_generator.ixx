@@ -0,0 +1,27 @@
+export module level_generator;
+
+import <cstdint>;
+import config;
+import random_service;
+
+// Level number used for layouts that do not come from assets/levelN.txt
+export constexpr int generatedLevelNumber = 0;
+// Level number of the endless mode, whose rows are generated while it is played
+export constexpr int endlessLevelNumber = -1;
+
+export struct LevelGeneratorParams {
+    int rows = 12;
+    int columns = 20;
+    float density = 0.85f;        // Chance that a cell holds a block
+    int normalWeight = 8;         // Relative block-type mix
+    int indestructibleWeight = 1;
+    int bonusWeight = 1;
+    std::uint64_t seed = 1;
+    float paddleWidth = 100.0f;
+    float ballSpeed = 300.0f;
+};
+
+export LevelConfig generateLevel(const LevelGeneratorParams& params);
+// Fills params.columns cells with one row of blocks. Expects parameters generateLevel accepts;
+// generateLevel draws every row this way, so both give the same rows for the same stream.
+export void generateRow(Xoshiro256& gen, const LevelGeneratorParams& params, LevelCell* cells);
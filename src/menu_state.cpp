@@ -1,29 +1,29 @@
 module menu_state;
 
+import asset_pack;
 import nickname_input_state;
 import playing_state;
 import <stdexcept>;
 import <vector>;
-import <filesystem>;
+import <algorithm>;
 import <iostream>;
+import random_service;
+import level_generator;
+import config;
+import level_catalog;
 
 MenuState::MenuState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm)
     : stateManager(sm), audioManager(am), highScoreManager(hsm), isSelectingLevel(false) {
     // Load font and check for success
-    if (!font.loadFromFile("assets/arial.ttf")) {
+    if (!loadFont(font, "assets/arial.ttf")) {
         throw std::runtime_error("Failed to load font: assets/arial.ttf");
     }
 
-    // Determine maxLevel by checking existing level files
-    maxLevel = 0;
-    while (std::filesystem::exists("assets/level" + std::to_string(maxLevel + 1) + ".txt")) {
-        ++maxLevel;
-    }
-    std::cout << "MenuState: Found " << maxLevel << " levels\n";
+    maxLevel = stateManager.getLevelCatalog().count();
     if (maxLevel == 0) {
-        throw std::runtime_error("No level files found in assets/");
+        throw std::runtime_error("No levels found in assets/");
     }
-    if (!backgroundTexture.loadFromFile("assets/background2.png")) {
+    if (!loadTexture(backgroundTexture, "assets/background2.png")) {
         throw std::runtime_error("Failed to load background texture");
     }
     backgroundSprite.setTexture(backgroundTexture);
@@ -42,7 +42,6 @@ MenuState::MenuState(GameStateManager& sm, AudioManager& am, HighScoreManager& h
     selectLevelText.setPosition(300, 300);
 
     highscoreText.setFont(font);
-    updateHighscoreText();
     highscoreText.setCharacterSize(20);
     highscoreText.setFillColor(sf::Color::White);
     highscoreText.setPosition(300, 400);
@@ -62,25 +61,111 @@ MenuState::MenuState(GameStateManager& sm, AudioManager& am, HighScoreManager& h
 
     overlay.setSize({ 800, 600 });
     overlay.setFillColor(sf::Color(0, 0, 0, 128));
-	am.playBackgroundMusic();
 
-    // Create level buttons
+    // Level slots on the left, page controls below them, preview and other modes on the right
     levelTexts.clear();
-    for (int i = 1; i <= maxLevel; ++i) {
+    for (int i = 0; i < levelsPerPage; ++i) {
         sf::Text levelText;
         levelText.setFont(font);
-        levelText.setString("Level " + std::to_string(i));
         levelText.setCharacterSize(30);
         levelText.setFillColor(sf::Color::White);
-        levelText.setPosition(300, 200 + i * 50);
+        levelText.setPosition(100, 230 + i * 45);
         levelTexts.push_back(levelText);
     }
 
+    for (auto* text : { &previousPageText, &pageText, &nextPageText }) {
+        text->setFont(font);
+        text->setCharacterSize(24);
+        text->setFillColor(sf::Color::White);
+    }
+    previousPageText.setString("< Prev");
+    previousPageText.setPosition(100, 510);
+    pageText.setPosition(210, 510);
+    nextPageText.setString("Next >");
+    nextPageText.setPosition(320, 510);
+
+    previewFrame.setSize({ 240, 120 });
+    previewFrame.setPosition(480, 230);
+    previewFrame.setFillColor(sf::Color(0, 0, 0, 160));
+    previewFrame.setOutlineThickness(2);
+    previewFrame.setOutlineColor(sf::Color::White);
+
+    generatedLevelText.setFont(font);
+    generatedLevelText.setString("Generated Level");
+    generatedLevelText.setCharacterSize(30);
+    generatedLevelText.setFillColor(sf::Color::White);
+    generatedLevelText.setPosition(480, 380);
+
+    endlessText.setFont(font);
+    endlessText.setString("Endless Mode");
+    endlessText.setCharacterSize(30);
+    endlessText.setFillColor(sf::Color::White);
+    endlessText.setPosition(480, 425);
+
     backText.setFont(font);
     backText.setString("Back");
     backText.setCharacterSize(30);
     backText.setFillColor(sf::Color::White);
-    backText.setPosition(300, 200 + (maxLevel + 1) * 50);
+    backText.setPosition(480, 470);
+
+    showLevelPage(0);
+}
+
+// Names and difficulty come from the catalog index, so paging never touches the filesystem
+void MenuState::showLevelPage(int page) {
+    int pageCount = (maxLevel + levelsPerPage - 1) / levelsPerPage;
+    levelPage = std::clamp(page, 0, pageCount - 1);
+    const LevelCatalog& catalog = stateManager.getLevelCatalog();
+    for (int i = 0; i < levelsPerPage; ++i) {
+        int level = levelInSlot(i);
+        std::string label;
+        if (level > 0) {
+            const LevelCatalogEntry& entry = catalog.entry(level);
+            label = std::to_string(level) + ". " + entry.name;
+            if (entry.difficulty > 0) {
+                label += "  " + std::string(entry.difficulty, '*');
+            }
+        }
+        levelTexts[i].setString(label);
+        levelTexts[i].setFillColor(sf::Color::White);
+    }
+    pageText.setString(std::to_string(levelPage + 1) + " / " + std::to_string(pageCount));
+    previousPageText.setFillColor(levelPage > 0 ? sf::Color::White : sf::Color(120, 120, 120));
+    nextPageText.setFillColor(levelPage + 1 < pageCount ? sf::Color::White : sf::Color(120, 120, 120));
+}
+
+int MenuState::levelInSlot(int slot) const {
+    int level = levelPage * levelsPerPage + slot + 1;
+    return level <= maxLevel ? level : 0;
+}
+
+// Thumbnails are loaded with the catalog, so hovering never touches the disk; loose levels have none
+void MenuState::showPreview(int level) {
+    if (level == previewLevel) {
+        return;
+    }
+    previewLevel = level;
+    previewVertices.clear();
+    const LevelThumbnail& thumbnail = stateManager.getLevelCatalog().thumbnail(level);
+    if (thumbnail.cells.empty()) {
+        return;
+    }
+    sf::Vector2f origin = previewFrame.getPosition() + sf::Vector2f(8, 8);
+    float cell = std::min((previewFrame.getSize().x - 16) / thumbnail.columns, (previewFrame.getSize().y - 16) / thumbnail.rows);
+    for (size_t row = 0; row < thumbnail.rows; ++row) {
+        for (size_t column = 0; column < thumbnail.columns; ++column) {
+            CellType type = thumbnail.cells[row * thumbnail.columns + column];
+            if (type == CellType::Empty) continue;
+            sf::Color color = type == CellType::Normal ? sf::Color::Green
+                : type == CellType::Indestructible ? sf::Color(100, 100, 100) : sf::Color::Yellow;
+            sf::Vector2f topLeft = origin + sf::Vector2f(column * cell, row * cell);
+            sf::Vector2f corners[4] = { topLeft, topLeft + sf::Vector2f(cell - 1, 0),
+                topLeft + sf::Vector2f(cell - 1, cell - 1), topLeft + sf::Vector2f(0, cell - 1) };
+            for (int index : { 0, 1, 2, 0, 2, 3 }) {
+                previewVertices.append(sf::Vertex(corners[index], color));
+            }
+        }
+    }
 }
 
 void MenuState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
@@ -90,17 +175,32 @@ void MenuState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
         mousePos = window.mapPixelToCoords(sf::Vector2i(event.mouseMove.x, event.mouseMove.y));
         // Aktualizuj kolory przycisków podczas ruchu myszy
         if (!isSelectingLevel) {
-            startText.setFillColor(startText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
+            bool overStart = startText.getGlobalBounds().contains(mousePos);
+            if (overStart) {
+                PlayingState::prefetch(stateManager, audioManager, highScoreManager, 1);
+            }
+            startText.setFillColor(overStart ? sf::Color::Green : sf::Color::White);
             selectLevelText.setFillColor(selectLevelText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
             exitText.setFillColor(exitText.getGlobalBounds().contains(mousePos) ? sf::Color::Red : sf::Color::White);
         }
         else {
-            for (auto& levelText : levelTexts) {
-                levelText.setFillColor(levelText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
+            for (int i = 0; i < levelsPerPage; ++i) {
+                int level = levelInSlot(i);
+                bool overLevel = level > 0 && levelTexts[i].getGlobalBounds().contains(mousePos);
+                if (overLevel) {
+                    PlayingState::prefetch(stateManager, audioManager, highScoreManager, level);
+                    showPreview(level);
+                }
+                levelTexts[i].setFillColor(overLevel ? sf::Color::Green : sf::Color::White);
             }
+            generatedLevelText.setFillColor(generatedLevelText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
+            endlessText.setFillColor(endlessText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
             backText.setFillColor(backText.getGlobalBounds().contains(mousePos) ? sf::Color::Red : sf::Color::White);
         }
     }
+    else if (event.type == sf::Event::MouseWheelScrolled && isSelectingLevel) {
+        showLevelPage(levelPage + (event.mouseWheelScroll.delta < 0 ? 1 : -1));
+    }
     else if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
         mousePos = window.mapPixelToCoords(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
         std::cout << "Mouse clicked at (" << mousePos.x << ", " << mousePos.y << ")\n";
@@ -108,7 +208,7 @@ void MenuState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
         if (!isSelectingLevel) {
             if (startText.getGlobalBounds().contains(mousePos)) {
                 std::cout << "Start Game clicked\n";
-                stateManager.setState<NicknameInputState>(stateManager, audioManager, highScoreManager, 1);
+                stateManager.showState<NicknameInputState>(stateManager, audioManager, highScoreManager).setStartLevel(1);
             }
             else if (selectLevelText.getGlobalBounds().contains(mousePos)) {
                 std::cout << "Select Level clicked\n";
@@ -121,15 +221,33 @@ void MenuState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
         }
         else {
             bool stateChanged = false;
-            for (int i = 0; i < levelTexts.size(); ++i) {
-                if (levelTexts[i].getGlobalBounds().contains(mousePos)) {
-                    std::cout << "Level " << (i + 1) << " clicked\n";
-                    stateManager.setState<NicknameInputState>(stateManager, audioManager, highScoreManager, i + 1);
+            for (int i = 0; i < levelsPerPage; ++i) {
+                int level = levelInSlot(i);
+                if (level > 0 && levelTexts[i].getGlobalBounds().contains(mousePos)) {
+                    std::cout << "Level " << level << " clicked\n";
+                    stateManager.showState<NicknameInputState>(stateManager, audioManager, highScoreManager).setStartLevel(level);
                     stateChanged = true;
                     break;
                 }
             }
-            if (!stateChanged && backText.getGlobalBounds().contains(mousePos)) {
+            if (!stateChanged && previousPageText.getGlobalBounds().contains(mousePos)) {
+                showLevelPage(levelPage - 1);
+            }
+            else if (!stateChanged && nextPageText.getGlobalBounds().contains(mousePos)) {
+                showLevelPage(levelPage + 1);
+            }
+            else if (!stateChanged && generatedLevelText.getGlobalBounds().contains(mousePos)) {
+                std::cout << "Generated Level clicked\n";
+                LevelGeneratorParams params;
+                params.seed = stateManager.getRandom().stream(RandomStream::Generator)();
+                stateManager.setGeneratedLevel(generateLevel(params));
+                stateManager.showState<NicknameInputState>(stateManager, audioManager, highScoreManager).setStartLevel(generatedLevelNumber);
+            }
+            else if (!stateChanged && endlessText.getGlobalBounds().contains(mousePos)) {
+                std::cout << "Endless Mode clicked\n";
+                stateManager.showState<NicknameInputState>(stateManager, audioManager, highScoreManager).setStartLevel(endlessLevelNumber);
+            }
+            else if (!stateChanged && backText.getGlobalBounds().contains(mousePos)) {
                 std::cout << "Back clicked\n";
                 isSelectingLevel = false;
             }
@@ -140,8 +258,23 @@ void MenuState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
 void MenuState::update(float deltaTime) {
 }
 
+bool MenuState::needsContinuousUpdate() const {
+    return false;
+}
+
+void MenuState::onEnter() {
+    audioManager.playBackgroundMusic();
+    isSelectingLevel = false;
+    updateHighscoreText();
+    for (auto* text : { &startText, &selectLevelText, &exitText, &generatedLevelText, &endlessText, &backText }) {
+        text->setFillColor(sf::Color::White);
+    }
+    for (auto& levelText : levelTexts) {
+        levelText.setFillColor(sf::Color::White);
+    }
+}
+
 void MenuState::draw(sf::RenderWindow& window) {
-    window.clear(sf::Color::Black);
     window.draw(backgroundSprite);
     if (!isSelectingLevel) {
         window.draw(startText);
@@ -155,9 +288,15 @@ void MenuState::draw(sf::RenderWindow& window) {
         for (const auto& levelText : levelTexts) {
             window.draw(levelText);
         }
+        window.draw(previousPageText);
+        window.draw(pageText);
+        window.draw(nextPageText);
+        window.draw(previewFrame);
+        window.draw(previewVertices);
+        window.draw(generatedLevelText);
+        window.draw(endlessText);
         window.draw(backText);
     }
-    window.display();
 }
 
 void MenuState::updateHighscoreText() {
@@ -13,6 +13,8 @@ public:
     void handleEvents(sf::RenderWindow& window, sf::Event& event) override;
     void update(float deltaTime) override;
     void draw(sf::RenderWindow& window) override;
+    bool needsContinuousUpdate() const override;
+    void onEnter() override;
 private:
     GameStateManager& stateManager;
     AudioManager& audioManager;
@@ -25,10 +27,24 @@ private:
     bool isSelectingLevel = false;
     sf::Text levelSelectTitle;
     sf::RectangleShape overlay;
-    std::vector<sf::Text> levelTexts;
+    // The level list shows one page of the catalog at a time
+    static constexpr int levelsPerPage = 6;
+    std::vector<sf::Text> levelTexts; // One per slot on the page
+    int levelPage = 0;
+    sf::Text previousPageText;
+    sf::Text nextPageText;
+    sf::Text pageText;
+    sf::RectangleShape previewFrame;
+    sf::VertexArray previewVertices{ sf::Triangles };
+    int previewLevel = 0;
+    sf::Text generatedLevelText;
+    sf::Text endlessText;
     sf::Text backText;
     sf::Texture backgroundTexture;
     sf::Sprite backgroundSprite;
     int maxLevel = 0;
     void updateHighscoreText();
+    void showLevelPage(int page);
+    void showPreview(int level);
+    int levelInSlot(int slot) const; // 0 for an empty slot
 };
\ No newline at end of file
@@ -1,16 +1,17 @@
 module nickname_input_state;
 
+import asset_pack;
 import playing_state;
+import player_registry;
 import <stdexcept>;
-import <cctype>;
 import <iostream>;
 
-NicknameInputState::NicknameInputState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int startLevel)
-    : stateManager(sm), audioManager(am), highScoreManager(hsm), startLevel(startLevel) {
-    if (!font.loadFromFile("assets/arial.ttf")) {
+NicknameInputState::NicknameInputState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm)
+    : stateManager(sm), audioManager(am), highScoreManager(hsm) {
+    if (!loadFont(font, "assets/arial.ttf")) {
         throw std::runtime_error("Failed to load font: assets/arial.ttf");
     }
-    if (!backgroundTexture.loadFromFile("assets/background2.png")) {
+    if (!loadTexture(backgroundTexture, "assets/background2.png")) {
         throw std::runtime_error("Failed to load background texture");
     }
     backgroundSprite.setTexture(backgroundTexture);
@@ -33,7 +34,24 @@ NicknameInputState::NicknameInputState(GameStateManager& sm, AudioManager& am, H
     errorText.setFillColor(sf::Color::Red);
     errorText.setPosition(100, 300);
 
-    std::cout << "NicknameInputState initialized with startLevel: " << startLevel << "\n";
+    suggestionsText.setFont(font);
+    suggestionsText.setCharacterSize(20);
+    suggestionsText.setFillColor(sf::Color(180, 180, 180));
+    suggestionsText.setPosition(100, 340);
+}
+
+void NicknameInputState::setStartLevel(int level) {
+    startLevel = level;
+}
+
+void NicknameInputState::onEnter() {
+    nickname.clear();
+    nicknameText.setString("");
+    errorText.setString("");
+    updateSuggestions();
+    std::cout << "NicknameInputState entered with startLevel: " << startLevel << "\n";
+    // The level is known already; build it while the player types
+    PlayingState::prefetch(stateManager, audioManager, highScoreManager, startLevel);
 }
 
 void NicknameInputState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
@@ -44,47 +62,29 @@ void NicknameInputState::handleEvents(sf::RenderWindow& window, sf::Event& event
                 nickname.pop_back();
                 errorText.setString("");
             }
-            else if (c == ' ') { // Handle space explicitly
-                errorText.setString("Spaces are not allowed!");
+            else if (c == '\t' && !suggestions.empty()) { // Complete to the first returning player
+                nickname = suggestions.front();
+                errorText.setString("");
             }
             else if (c >= 32) {
-                std::string tempNickname = nickname + c;
-                std::regex charRegex(nickname.empty() ? "^[A-Z]$" : "^[A-Z][A-Za-z0-9]{0,9}$");
-                if (tempNickname.length() <= 10 && std::regex_match(tempNickname, charRegex)) {
+                NicknameError error = checkNickname(nickname + c);
+                if (error == NicknameError::None) {
                     nickname += c;
-                    errorText.setString("");
-                }
-                else {
-                    if (nickname.empty() && (c < 'A' || c > 'Z')) {
-                        errorText.setString("Must start with a capital letter!");
-                    }
-                    else if (!std::isalnum(c)) {
-                        errorText.setString("Only letters and numbers allowed!");
-                    }
-                    else if (tempNickname.length() > 10) {
-                        errorText.setString("Nickname must be 10 characters or less!");
-                    }
                 }
+                errorText.setString(nicknameErrorMessage(error));
             }
             nicknameText.setString(nickname);
+            updateSuggestions();
         }
     }
     if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Enter && !nickname.empty()) {
-        std::regex nicknameRegex("^[A-Z][A-Za-z0-9]{0,9}$");
-        if (std::regex_match(nickname, nicknameRegex)) {
-            if (!highScoreManager.isNicknameUnique(nickname) && std::filesystem::exists("players/" + nickname + ".txt")) {
-                std::cout << "Nickname entered: " << nickname << ", starting level " << startLevel << "\n";
-                stateManager.setNickname(nickname);
-                stateManager.setState<PlayingState>(stateManager, audioManager, highScoreManager, startLevel);
-            }
-            else if (highScoreManager.isNicknameUnique(nickname)) {
-                std::cout << "Nickname entered: " << nickname << ", starting level " << startLevel << "\n";
-                stateManager.setNickname(nickname);
-                stateManager.setState<PlayingState>(stateManager, audioManager, highScoreManager, startLevel);
-            }
-            else {
-                errorText.setString("Nickname already taken!");
-            }
+        if (checkNickname(nickname) == NicknameError::None) {
+            // Known nicknames belong to returning players and continue their history
+            bool returning = !highScoreManager.isNicknameUnique(nickname);
+            std::cout << "Nickname entered: " << nickname << (returning ? " (returning)" : " (new)")
+                << ", starting level " << startLevel << "\n";
+            stateManager.setNickname(nickname);
+            PlayingState::start(stateManager, audioManager, highScoreManager, startLevel);
         }
         else {
             errorText.setString("Invalid nickname format!");
@@ -92,15 +92,30 @@ void NicknameInputState::handleEvents(sf::RenderWindow& window, sf::Event& event
     }
 }
 
+void NicknameInputState::updateSuggestions() {
+    suggestions.clear();
+    if (!nickname.empty()) {
+        suggestions = highScoreManager.getPlayerRegistry().suggest(nickname, 5);
+    }
+    std::string text;
+    for (const auto& suggestion : suggestions) {
+        text += (text.empty() ? "Returning players (Tab): " : ", ") + suggestion;
+    }
+    suggestionsText.setString(text);
+}
+
 void NicknameInputState::update(float deltaTime) {
     nicknameText.setString(nickname);
 }
 
+bool NicknameInputState::needsContinuousUpdate() const {
+    return false;
+}
+
 void NicknameInputState::draw(sf::RenderWindow& window) {
-    window.clear(sf::Color::Black);
     window.draw(backgroundSprite);
     window.draw(promptText);
     window.draw(nicknameText);
     window.draw(errorText);
-    window.display();
+    window.draw(suggestionsText);
 }
\ No newline at end of file
@@ -2,8 +2,7 @@ export module nickname_input_state;
 
 import <SFML/Graphics.hpp>;
 import <string>;
-import <regex>;
-import <filesystem>;
+import <vector>;
 import game_state;
 import game_state_manager;
 import audio;
@@ -11,20 +10,27 @@ import highscore;
 
 export class NicknameInputState : public GameState {
 public:
-    NicknameInputState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int startLevel = 1); // Added startLevel
+    NicknameInputState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm);
+    void setStartLevel(int level);
     void handleEvents(sf::RenderWindow& window, sf::Event& event) override;
     void update(float deltaTime) override;
     void draw(sf::RenderWindow& window) override;
+    bool needsContinuousUpdate() const override;
+    void onEnter() override;
 private:
     sf::Font font;
     sf::Text promptText;
     sf::Text nicknameText;
     sf::Text errorText;
+    sf::Text suggestionsText;
     std::string nickname;
+    std::vector<std::string> suggestions;
     GameStateManager& stateManager;
     AudioManager& audioManager;
     HighScoreManager& highScoreManager;
     sf::Texture backgroundTexture;
     sf::Sprite backgroundSprite;
-    int startLevel; // Added to store selected level
+    int startLevel = 1;
+
+    void updateSuggestions();
 };
\ No newline at end of file
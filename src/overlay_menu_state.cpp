@@ -0,0 +1,97 @@
+module overlay_menu_state;
+
+import <iostream>;
+
+namespace {
+    const sf::Color disabledColor(128, 128, 128);
+}
+
+OverlayMenuState::OverlayMenuState(const sf::Font& font, const std::string& title, sf::Vector2f titlePosition)
+    : font(font) {
+    overlay.setSize({ 800, 600 });
+    overlay.setFillColor(sf::Color(0, 0, 0, 128));
+
+    titleText.setFont(font);
+    titleText.setString(title);
+    titleText.setCharacterSize(50);
+    titleText.setFillColor(sf::Color::White);
+    titleText.setPosition(titlePosition);
+}
+
+void OverlayMenuState::setTitle(const std::string& title) {
+    titleText.setString(title);
+}
+
+void OverlayMenuState::addButton(const std::string& label, sf::Color hoverColor, Action action) {
+    Button button;
+    button.text.setFont(font);
+    button.text.setString(label);
+    button.text.setCharacterSize(30);
+    button.text.setFillColor(sf::Color::White);
+    button.text.setPosition(300, 250 + 50.0f * buttons.size());
+    button.hoverColor = hoverColor;
+    button.action = std::move(action);
+    buttons.push_back(std::move(button));
+}
+
+void OverlayMenuState::setButtonEnabled(size_t index, bool enabled) {
+    buttons.at(index).enabled = enabled;
+    buttons[index].text.setFillColor(enabled ? sf::Color::White : disabledColor);
+}
+
+void OverlayMenuState::setEscapeAction(Action action) {
+    escapeAction = std::move(action);
+}
+
+void OverlayMenuState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape && escapeAction) {
+        escapeAction(window);
+    }
+    else if (event.type == sf::Event::MouseMoved) {
+        updateButtonColors(window.mapPixelToCoords(sf::Vector2i(event.mouseMove.x, event.mouseMove.y)));
+    }
+    else if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+        sf::Vector2f mousePos = window.mapPixelToCoords(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
+        std::cout << "Mouse clicked at (" << mousePos.x << ", " << mousePos.y << ")\n";
+        for (auto& button : buttons) {
+            if (button.enabled && button.text.getGlobalBounds().contains(mousePos)) {
+                std::cout << std::string(button.text.getString()) << " clicked\n";
+                button.action(window);
+                break;
+            }
+        }
+    }
+}
+
+void OverlayMenuState::update(float deltaTime) {
+}
+
+void OverlayMenuState::draw(sf::RenderWindow& window) {
+    window.draw(overlay);
+    window.draw(titleText);
+    for (const auto& button : buttons) {
+        window.draw(button.text);
+    }
+}
+
+bool OverlayMenuState::needsContinuousUpdate() const {
+    return false;
+}
+
+bool OverlayMenuState::isOverlay() const {
+    return true;
+}
+
+void OverlayMenuState::onEnter() {
+    // Forget the hover highlight from the previous visit
+    for (auto& button : buttons) {
+        button.text.setFillColor(button.enabled ? sf::Color::White : disabledColor);
+    }
+}
+
+void OverlayMenuState::updateButtonColors(sf::Vector2f mousePos) {
+    for (auto& button : buttons) {
+        if (!button.enabled) continue;
+        button.text.setFillColor(button.text.getGlobalBounds().contains(mousePos) ? button.hoverColor : sf::Color::White);
+    }
+}
@@ -0,0 +1,42 @@
+export module overlay_menu_state;
+
+import <SFML/Graphics.hpp>;
+import <functional>;
+import <string>;
+import <vector>;
+import game_state;
+
+// Dimmed menu drawn over the state below it (pause, level complete). Buttons are stacked
+// under the title and run their action when clicked.
+export class OverlayMenuState : public GameState {
+public:
+    using Action = std::function<void(sf::RenderWindow&)>;
+
+    OverlayMenuState(const sf::Font& font, const std::string& title, sf::Vector2f titlePosition);
+    void setTitle(const std::string& title);
+    void addButton(const std::string& label, sf::Color hoverColor, Action action);
+    void setButtonEnabled(size_t index, bool enabled);
+    void setEscapeAction(Action action);
+
+    void handleEvents(sf::RenderWindow& window, sf::Event& event) override;
+    void update(float deltaTime) override;
+    void draw(sf::RenderWindow& window) override;
+    bool needsContinuousUpdate() const override;
+    bool isOverlay() const override;
+    void onEnter() override;
+private:
+    struct Button {
+        sf::Text text;
+        sf::Color hoverColor;
+        Action action;
+        bool enabled = true;
+    };
+
+    const sf::Font& font;
+    sf::RectangleShape overlay;
+    sf::Text titleText;
+    std::vector<Button> buttons;
+    Action escapeAction;
+
+    void updateButtonColors(sf::Vector2f mousePos);
+};
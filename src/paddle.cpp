@@ -62,4 +62,12 @@ void Paddle::resetWidth() {
 
 sf::Vector2f Paddle::getVelocity() const {
     return velocity;
+}
+
+sf::Vector2f Paddle::getPosition() const {
+    return shape.getPosition();
+}
+
+sf::Vector2f Paddle::getSize() const {
+    return shape.getSize();
 }
\ No newline at end of file
@@ -12,6 +12,8 @@ public:
     void extend(float factor = 1.5f);
     void resetWidth();
     sf::Vector2f getVelocity() const; // Dodana metoda getVelocity
+    sf::Vector2f getPosition() const;
+    sf::Vector2f getSize() const;
 private:
     sf::RectangleShape shape;
     float speed = 500.0f;
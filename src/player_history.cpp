@@ -0,0 +1,290 @@
+module player_history;
+
+import <algorithm>;
+import <array>;
+import <charconv>;
+import <filesystem>;
+import <fstream>;
+import <iostream>;
+import <stdexcept>;
+import <string_view>;
+import <type_traits>;
+import durable_file;
+import player_store;
+import trace;
+
+namespace {
+    constexpr std::array<char, 8> summaryMagic = { 'A', 'R', 'K', 'P', 'L', 'Y', 'R', '1' };
+    const std::string generationPrefix = "# generation ";
+
+    struct PlayerSummary {
+        std::uint32_t generation = 0;
+        std::uint64_t consumedTailBytes = 0;
+        std::uint32_t consumedTailChecksum = 0;
+        PlayerHistory history;
+    };
+
+    template<typename T>
+    T readInteger(std::string_view data, std::size_t& pos) {
+        if (pos + sizeof(T) > data.size()) {
+            throw std::runtime_error("Player summary is truncated");
+        }
+        std::make_unsigned_t<T> value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<std::make_unsigned_t<T>>(static_cast<std::uint8_t>(data[pos + i])) << (8 * i);
+        }
+        pos += sizeof(T);
+        return static_cast<T>(value);
+    }
+
+    template<typename T>
+    void appendInteger(std::string& out, T value) {
+        auto bits = static_cast<std::make_unsigned_t<T>>(value);
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+        }
+    }
+
+    std::string readWholeFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            return {};
+        }
+        std::string data(static_cast<std::size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        return data;
+    }
+
+    std::string serializeSummary(const PlayerSummary& summary) {
+        std::string out(summaryMagic.begin(), summaryMagic.end());
+        appendInteger(out, summary.generation);
+        appendInteger(out, summary.consumedTailBytes);
+        appendInteger(out, summary.consumedTailChecksum);
+        appendInteger(out, static_cast<std::uint32_t>(summary.history.levels.size()));
+        for (const auto& stats : summary.history.levels) {
+            appendInteger(out, static_cast<std::int32_t>(stats.level));
+            appendInteger(out, static_cast<std::int32_t>(stats.best));
+            appendInteger(out, stats.games);
+            appendInteger(out, stats.total);
+        }
+        appendInteger(out, static_cast<std::uint32_t>(summary.history.recentGames.size()));
+        for (const auto& game : summary.history.recentGames) {
+            appendInteger(out, static_cast<std::int32_t>(game.level));
+            appendInteger(out, static_cast<std::int32_t>(game.score));
+        }
+        appendInteger(out, recordChecksum(out));
+        return out;
+    }
+
+    PlayerSummary parseSummary(std::string_view data) {
+        if (data.size() < summaryMagic.size() + sizeof(std::uint32_t)
+            || !std::equal(summaryMagic.begin(), summaryMagic.end(), data.begin())) {
+            throw std::runtime_error("Not a player summary");
+        }
+        std::size_t checksumPos = data.size() - sizeof(std::uint32_t);
+        if (readInteger<std::uint32_t>(data, checksumPos) != recordChecksum(data.substr(0, data.size() - sizeof(std::uint32_t)))) {
+            throw std::runtime_error("Player summary checksum mismatch");
+        }
+        std::size_t pos = summaryMagic.size();
+        PlayerSummary summary;
+        summary.generation = readInteger<std::uint32_t>(data, pos);
+        summary.consumedTailBytes = readInteger<std::uint64_t>(data, pos);
+        summary.consumedTailChecksum = readInteger<std::uint32_t>(data, pos);
+        auto levelCount = readInteger<std::uint32_t>(data, pos);
+        for (std::uint32_t i = 0; i < levelCount; ++i) {
+            LevelStats stats;
+            stats.level = readInteger<std::int32_t>(data, pos);
+            stats.best = readInteger<std::int32_t>(data, pos);
+            stats.games = readInteger<std::uint32_t>(data, pos);
+            stats.total = readInteger<std::int64_t>(data, pos);
+            summary.history.levels.push_back(stats);
+        }
+        auto recentCount = readInteger<std::uint32_t>(data, pos);
+        for (std::uint32_t i = 0; i < recentCount; ++i) {
+            PlayedGame game;
+            game.level = readInteger<std::int32_t>(data, pos);
+            game.score = readInteger<std::int32_t>(data, pos);
+            summary.history.recentGames.push_back(game);
+        }
+        return summary;
+    }
+
+    // Falls back to the previous summary when the current one is damaged
+    PlayerSummary loadSummary(const std::string& path) {
+        for (const std::string& candidate : { path, path + ".bak" }) {
+            std::string data = readWholeFile(candidate);
+            if (data.empty()) {
+                continue;
+            }
+            try {
+                PlayerSummary summary = parseSummary(data);
+                if (candidate != path) {
+                    std::cerr << "Recovered player summary from " << candidate << "\n";
+                }
+                return summary;
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Ignoring " << candidate << ": " << e.what() << "\n";
+            }
+        }
+        return {};
+    }
+
+    // Returns the part of the tail that the summary has not consumed yet. A tail that starts
+    // with the summary's generation was restarted after the summary was written; otherwise a
+    // crash came in between and the consumed bytes are still at the front.
+    std::string_view unconsumedTail(std::string_view tail, const PlayerSummary& summary) {
+        if (summary.generation == 0) {
+            return tail;
+        }
+        std::string marker = generationPrefix + std::to_string(summary.generation);
+        if (tail.starts_with(marker) && (tail.size() == marker.size() || tail[marker.size()] == '\n' || tail[marker.size()] == '\r')) {
+            return tail;
+        }
+        if (tail.size() >= summary.consumedTailBytes
+            && recordChecksum(tail.substr(0, summary.consumedTailBytes)) == summary.consumedTailChecksum) {
+            return tail.substr(summary.consumedTailBytes);
+        }
+        return tail;
+    }
+
+    std::string_view trimLine(std::string_view line) {
+        while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) line.remove_prefix(1);
+        while (!line.empty() && (line.back() == ' ' || line.back() == '\t' || line.back() == '\r')) line.remove_suffix(1);
+        return line;
+    }
+
+    bool parseNumber(std::string_view text, int& value) {
+        text = trimLine(text);
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    // Accepts "Level N: score", "N: score" and a bare score
+    void replayTail(std::string_view tail, PlayerHistory& history) {
+        while (!tail.empty()) {
+            std::size_t end = tail.find('\n');
+            std::string_view line = trimLine(tail.substr(0, end));
+            tail.remove_prefix(end == std::string_view::npos ? tail.size() : end + 1);
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+            if (line.starts_with("Level ")) {
+                line.remove_prefix(6);
+            }
+            int level = 0;
+            int score = 0;
+            std::size_t colon = line.find(':');
+            bool valid = colon == std::string_view::npos
+                ? parseNumber(line, score)
+                : parseNumber(line.substr(0, colon), level) && parseNumber(line.substr(colon + 1), score);
+            if (valid) {
+                history.record(level, score);
+            }
+        }
+    }
+
+    std::uintmax_t fileSize(const std::string& path) {
+        std::error_code error;
+        auto size = std::filesystem::file_size(path, error);
+        return error ? 0 : size;
+    }
+}
+
+void PlayerHistory::record(int level, int score) {
+    auto it = std::lower_bound(levels.begin(), levels.end(), level,
+        [](const LevelStats& stats, int value) { return stats.level < value; });
+    if (it == levels.end() || it->level != level) {
+        it = levels.insert(it, LevelStats{ level, score, 0, 0 });
+    }
+    it->best = std::max(it->best, score);
+    ++it->games;
+    it->total += score;
+
+    if (recentGames.size() == recentGameLimit) {
+        recentGames.erase(recentGames.begin());
+    }
+    recentGames.push_back({ level, score });
+}
+
+int PlayerHistory::bestScore() const {
+    int best = 0;
+    for (const auto& stats : levels) {
+        best = std::max(best, stats.best);
+    }
+    return best;
+}
+
+std::uint32_t PlayerHistory::gamesPlayed() const {
+    std::uint32_t games = 0;
+    for (const auto& stats : levels) {
+        games += stats.games;
+    }
+    return games;
+}
+
+bool PlayerHistory::empty() const {
+    return levels.empty();
+}
+
+std::string playerHistoryLine(int level, int score) {
+    return "Level " + std::to_string(level) + ": " + std::to_string(score) + "\n";
+}
+
+PlayerHistory loadPlayerHistory(const std::string& directory, const std::string& nickname) {
+    TraceScope scope("LoadPlayerHistory", "io");
+    std::string base = playerBasePath(directory, nickname);
+    PlayerSummary summary = loadSummary(base + ".sum");
+    std::string tail = readWholeFile(base + ".txt");
+    replayTail(unconsumedTail(tail, summary), summary.history);
+    return std::move(summary.history);
+}
+
+bool compactPlayerHistory(const std::string& directory, const std::string& nickname, std::uintmax_t minimumTailBytes) {
+    TraceScope scope("CompactPlayerHistory", "io");
+    std::string base = playerBasePath(directory, nickname);
+    std::string tail = readWholeFile(base + ".txt");
+    PlayerSummary summary = loadSummary(base + ".sum");
+    std::string_view pending = unconsumedTail(tail, summary);
+    if (pending.size() < minimumTailBytes) {
+        return false;
+    }
+    std::uint32_t gamesBefore = summary.history.gamesPlayed();
+    replayTail(pending, summary.history);
+    if (summary.history.gamesPlayed() == gamesBefore) {
+        return false;
+    }
+
+    ++summary.generation;
+    summary.consumedTailBytes = tail.size();
+    summary.consumedTailChecksum = recordChecksum(tail);
+    writeFileAtomically(base + ".sum", serializeSummary(summary), true);
+    writeFileAtomically(base + ".txt", generationPrefix + std::to_string(summary.generation) + "\n", true);
+    std::filesystem::remove(base + ".txt.bak");
+    return true;
+}
+
+CompactionReport compactPlayerHistories(const std::string& directory, std::uintmax_t minimumTailBytes, std::stop_token stopToken) {
+    TraceScope scope("CompactPlayerHistories", "io");
+    CompactionReport report;
+    for (const auto& nickname : listPlayers(directory)) {
+        if (stopToken.stop_requested()) {
+            break;
+        }
+        ++report.players;
+        std::string base = playerBasePath(directory, nickname);
+        std::uintmax_t before = fileSize(base + ".txt") + fileSize(base + ".sum");
+        try {
+            if (compactPlayerHistory(directory, nickname, minimumTailBytes)) {
+                ++report.compacted;
+                report.bytesBefore += before;
+                report.bytesAfter += fileSize(base + ".txt") + fileSize(base + ".sum");
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to compact history of " << nickname << ": " << e.what() << "\n";
+        }
+    }
+    return report;
+}
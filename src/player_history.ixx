@@ -0,0 +1,60 @@
+export module player_history;
+
+import <cstdint>;
+import <stop_token>;
+import <string>;
+import <vector>;
+
+// A player's games live in two files in the player's shard (see player_store). NAME.txt is an
+// append-only text tail with one "Level N: score" line per game (older files also hold
+// "N: score" lines and bare scores, which count as level 0). Compaction folds the tail into
+// NAME.sum, a binary summary:
+// "ARKPLYR1", uint32 generation, uint64 size and uint32 checksum of the tail it consumed,
+// uint32 level count, per level int32 level, int32 best, uint32 games and int64 total, uint32
+// recent game count, per game int32 level and int32 score, then a uint32 checksum of
+// everything before it. Integers are little-endian. The tail is then restarted with a
+// "# generation G" line, so a crash between the two writes is detected and the consumed part
+// is not counted twice.
+
+export struct LevelStats {
+    int level = 0;
+    int best = 0;
+    std::uint32_t games = 0;
+    std::int64_t total = 0;
+};
+
+export struct PlayedGame {
+    int level = 0;
+    int score = 0;
+};
+
+export struct PlayerHistory {
+    static constexpr std::size_t recentGameLimit = 10;
+
+    std::vector<LevelStats> levels;      // Sorted by level
+    std::vector<PlayedGame> recentGames; // Oldest first
+
+    void record(int level, int score);
+    int bestScore() const;
+    std::uint32_t gamesPlayed() const;
+    bool empty() const;
+};
+
+export std::string playerHistoryLine(int level, int score);
+
+// Summary plus tail
+export PlayerHistory loadPlayerHistory(const std::string& directory, const std::string& nickname);
+
+// Folds the tail into the summary when it is at least minimumTailBytes long. Returns true if
+// the player was compacted.
+export bool compactPlayerHistory(const std::string& directory, const std::string& nickname, std::uintmax_t minimumTailBytes);
+
+export struct CompactionReport {
+    int players = 0;
+    int compacted = 0;
+    std::uintmax_t bytesBefore = 0; // Tails and summaries of the compacted players
+    std::uintmax_t bytesAfter = 0;
+};
+
+// Compacts every player in the directory, stopping early when requested
+export CompactionReport compactPlayerHistories(const std::string& directory, std::uintmax_t minimumTailBytes, std::stop_token stopToken = {});
@@ -0,0 +1,111 @@
+module player_registry;
+
+import <algorithm>;
+import <functional>;
+import <mutex>;
+
+NicknameError checkNickname(std::string_view nickname) {
+    if (nickname.empty()) {
+        return NicknameError::Empty;
+    }
+    if (nickname.find(' ') != std::string_view::npos) {
+        return NicknameError::Space;
+    }
+    if (nickname.front() < 'A' || nickname.front() > 'Z') {
+        return NicknameError::NotCapital;
+    }
+    for (char c : nickname) {
+        bool alphanumeric = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+        if (!alphanumeric) {
+            return NicknameError::NotAlphanumeric;
+        }
+    }
+    if (nickname.size() > maxNicknameLength) {
+        return NicknameError::TooLong;
+    }
+    return NicknameError::None;
+}
+
+const char* nicknameErrorMessage(NicknameError error) {
+    switch (error) {
+    case NicknameError::None: return "";
+    case NicknameError::Empty: return "Enter a nickname!";
+    case NicknameError::Space: return "Spaces are not allowed!";
+    case NicknameError::NotCapital: return "Must start with a capital letter!";
+    case NicknameError::NotAlphanumeric: return "Only letters and numbers allowed!";
+    case NicknameError::TooLong: return "Nickname must be 10 characters or less!";
+    }
+    return "Invalid nickname format!";
+}
+
+PlayerRegistry::PlayerRegistry()
+    : nodes(1) {
+}
+
+void PlayerRegistry::add(const std::string& nickname) {
+    std::unique_lock lock(mutex);
+    if (names.insert(nickname).second) {
+        insertIntoTrie(nickname);
+    }
+}
+
+bool PlayerRegistry::contains(std::string_view nickname) const {
+    std::shared_lock lock(mutex);
+    return names.find(nickname) != names.end();
+}
+
+std::vector<std::string> PlayerRegistry::suggest(std::string_view prefix, std::size_t limit) const {
+    std::vector<std::string> suggestions;
+    std::shared_lock lock(mutex);
+    std::uint32_t node = 0;
+    for (char c : prefix) {
+        const auto& children = nodes[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), c,
+            [](const auto& child, char value) { return child.first < value; });
+        if (it == children.end() || it->first != c) {
+            return suggestions;
+        }
+        node = it->second;
+    }
+
+    // Depth first, children in character order, so the names come out sorted
+    std::string name(prefix);
+    std::function<void(std::uint32_t)> collect = [&](std::uint32_t current) {
+        if (suggestions.size() >= limit) return;
+        if (nodes[current].terminal) {
+            suggestions.push_back(name);
+        }
+        for (const auto& [c, child] : nodes[current].children) {
+            name.push_back(c);
+            collect(child);
+            name.pop_back();
+        }
+    };
+    collect(node);
+    return suggestions;
+}
+
+std::size_t PlayerRegistry::size() const {
+    std::shared_lock lock(mutex);
+    return names.size();
+}
+
+void PlayerRegistry::insertIntoTrie(std::string_view nickname) {
+    std::uint32_t node = 0;
+    for (char c : nickname) {
+        auto& children = nodes[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), c,
+            [](const auto& child, char value) { return child.first < value; });
+        if (it == children.end() || it->first != c) {
+            auto next = static_cast<std::uint32_t>(nodes.size());
+            children.insert(it, { c, next });
+            // emplace_back may move the nodes, so children is not used after it
+            nodes.emplace_back();
+            node = next;
+        }
+        else {
+            node = it->second;
+        }
+    }
+    nodes[node].terminal = true;
+}
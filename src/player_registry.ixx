@@ -0,0 +1,56 @@
+export module player_registry;
+
+import <cstddef>;
+import <cstdint>;
+import <functional>;
+import <shared_mutex>;
+import <string>;
+import <string_view>;
+import <unordered_set>;
+import <utility>;
+import <vector>;
+
+export constexpr std::size_t maxNicknameLength = 10;
+
+export enum class NicknameError {
+    None,
+    Empty,
+    Space,
+    NotCapital,      // Must start with A-Z
+    NotAlphanumeric,
+    TooLong,
+};
+
+// Nicknames are a capital letter followed by up to nine letters or digits
+export NicknameError checkNickname(std::string_view nickname);
+export const char* nicknameErrorMessage(NicknameError error);
+
+// Every known nickname, held in memory so input screens never touch the disk: a hash set
+// answers "is this name taken" and a trie lists returning players by prefix. Filled once from
+// the players directory and kept current by HighScoreManager; safe to read while another
+// thread adds.
+export class PlayerRegistry {
+public:
+    PlayerRegistry();
+    void add(const std::string& nickname);
+    bool contains(std::string_view nickname) const;
+    // Up to limit known nicknames starting with prefix, in alphabetical order
+    std::vector<std::string> suggest(std::string_view prefix, std::size_t limit) const;
+    std::size_t size() const;
+private:
+    struct TrieNode {
+        std::vector<std::pair<char, std::uint32_t>> children; // Sorted by character
+        bool terminal = false;
+    };
+
+    struct NameHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    mutable std::shared_mutex mutex;
+    std::unordered_set<std::string, NameHash, std::equal_to<>> names;
+    std::vector<TrieNode> nodes; // nodes[0] is the root
+
+    void insertIntoTrie(std::string_view nickname);
+};
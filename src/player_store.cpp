@@ -0,0 +1,142 @@
+module player_store;
+
+import <cctype>;
+import <cstdint>;
+import <cstdio>;
+import <filesystem>;
+import <fstream>;
+import <iostream>;
+import <sstream>;
+import <unordered_map>;
+import durable_file;
+import trace;
+
+namespace {
+    const std::string indexHeader = "# players v1";
+
+    std::string shardName(std::string_view nickname) {
+        char name[3];
+        std::snprintf(name, sizeof(name), "%02x", static_cast<unsigned>(recordChecksum(nickname) & 0xFF));
+        return name;
+    }
+
+    bool isShardName(const std::string& name) {
+        return name.size() == 2 && std::isxdigit(static_cast<unsigned char>(name[0])) && std::isxdigit(static_cast<unsigned char>(name[1]));
+    }
+}
+
+std::string playerBasePath(const std::string& directory, std::string_view nickname) {
+    std::string path = directory;
+    path += '/';
+    path += shardName(nickname);
+    path += '/';
+    path += nickname;
+    return path;
+}
+
+int migrateFlatPlayers(const std::string& directory) {
+    TraceScope scope("MigratePlayers", "io");
+    std::vector<std::filesystem::path> flatFiles;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (entry.is_regular_file() && !name.starts_with("index.txt")) {
+            flatFiles.push_back(entry.path());
+        }
+    }
+
+    // Nicknames have no dots, so everything up to the first one is the owner: Alice.txt,
+    // Alice.sum, Alice.txt.bak and so on all move together
+    int moved = 0;
+    for (const auto& file : flatFiles) {
+        std::string name = file.filename().string();
+        std::string nickname = name.substr(0, name.find('.'));
+        if (nickname.empty()) {
+            continue;
+        }
+        std::filesystem::path target = playerBasePath(directory, nickname) + name.substr(nickname.size());
+        std::filesystem::create_directories(target.parent_path());
+        if (std::filesystem::exists(target)) {
+            std::cerr << "Not migrating " << file.string() << ": " << target.string() << " already exists\n";
+            continue;
+        }
+        std::filesystem::rename(file, target);
+        if (file.extension() == ".txt") {
+            ++moved;
+        }
+    }
+    if (moved > 0) {
+        std::cout << "Moved " << moved << " players into the sharded layout\n";
+    }
+    return moved;
+}
+
+std::vector<std::string> listPlayers(const std::string& directory) {
+    TraceScope scope("ListPlayers", "io");
+    std::vector<std::string> nicknames;
+    std::error_code error;
+    for (const auto& shard : std::filesystem::directory_iterator(directory, error)) {
+        if (!shard.is_directory() || !isShardName(shard.path().filename().string())) {
+            continue;
+        }
+        for (const auto& entry : std::filesystem::directory_iterator(shard.path())) {
+            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+                nicknames.push_back(entry.path().stem().string());
+            }
+        }
+    }
+    return nicknames;
+}
+
+std::string playerIndexPath(const std::string& directory) {
+    return directory + "/index.txt";
+}
+
+PlayerIndex readPlayerIndex(const std::string& directory) {
+    TraceScope scope("ReadPlayerIndex", "io");
+    PlayerIndex index;
+    std::ifstream file(playerIndexPath(directory));
+    if (!file.is_open()) {
+        return index;
+    }
+    index.found = true;
+    std::unordered_map<std::string, std::size_t> positions;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line.front() == '#') continue;
+        ++index.lines;
+        std::istringstream iss(line);
+        std::string nickname;
+        int best = 0;
+        std::uint32_t checksum = 0;
+        if (!(iss >> nickname >> best >> std::hex >> checksum)
+            || checksum != recordChecksum(nickname + " " + std::to_string(best))) {
+            ++index.damagedLines;
+            continue;
+        }
+        auto [it, inserted] = positions.try_emplace(nickname, index.players.size());
+        if (inserted) {
+            index.players.emplace_back(nickname, best);
+        }
+        else if (best > index.players[it->second].second) {
+            index.players[it->second].second = best;
+        }
+    }
+    return index;
+}
+
+std::string playerIndexLine(const std::string& nickname, int best) {
+    std::string record = nickname + " " + std::to_string(best);
+    char checksum[16];
+    std::snprintf(checksum, sizeof(checksum), " %08x\n", recordChecksum(record));
+    return record + checksum;
+}
+
+std::string serializePlayerIndex(const std::vector<std::pair<std::string, int>>& players) {
+    std::string text = indexHeader + "\n";
+    for (const auto& [nickname, best] : players) {
+        text += playerIndexLine(nickname, best);
+    }
+    return text;
+}
@@ -0,0 +1,41 @@
+export module player_store;
+
+import <cstddef>;
+import <string>;
+import <string_view>;
+import <utility>;
+import <vector>;
+
+// On-disk layout of the players directory. Each player's files live in one of 256 shard
+// directories named after the low byte of the nickname's checksum, e.g. players/3f/Alice.txt,
+// so no directory grows past a few hundred entries and a player's files are found from the
+// nickname alone. players/index.txt lists every player with their best score, so startup
+// reads one file instead of every history.
+//
+// The index is append-only: "# players v1", then "nickname best checksum" lines (checksum as
+// in leaderboard_file). A player can appear many times; the highest score counts.
+
+// Path of the player's files without extension: directory/xx/nickname
+export std::string playerBasePath(const std::string& directory, std::string_view nickname);
+
+// Moves players stored flat in the directory (the old layout) into their shards. Only the top
+// level is listed, which after migration holds just the shards and the index. Returns the
+// number of players moved.
+export int migrateFlatPlayers(const std::string& directory);
+
+// Every player with a history file, found by listing all shards. Slow on large player bases;
+// only used to rebuild a missing index and by offline tools.
+export std::vector<std::string> listPlayers(const std::string& directory);
+
+export struct PlayerIndex {
+    bool found = false;
+    std::vector<std::pair<std::string, int>> players; // Nickname, best score; one entry each
+    std::size_t lines = 0;                            // Records in the file, duplicates included
+    int damagedLines = 0;
+};
+
+export std::string playerIndexPath(const std::string& directory);
+export PlayerIndex readPlayerIndex(const std::string& directory);
+export std::string playerIndexLine(const std::string& nickname, int best);
+// Complete index text with one line per player
+export std::string serializePlayerIndex(const std::vector<std::pair<std::string, int>>& players);
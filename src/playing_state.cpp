@@ -1,43 +1,71 @@
 module playing_state;
 
+import asset_pack;
 import menu_state;
 import game_over_state;
 import ball;
+import texture_cache;
+import level_generator;
+import level_catalog;
 import <stdexcept>;
-import <filesystem>;
 import <iostream>;
+import <chrono>;
+import <charconv>;
+import <optional>;
+import <algorithm>;
+import trace;
+import flight_recorder;
+import alloc_tracker;
 
-PlayingState::PlayingState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int startLevel)
-    : stateManager(sm), audioManager(am), highScoreManager(hsm), collisionSystem(am), stateChanged(false), isLevelComplete(false), currentLevel(startLevel) {
-    maxLevel = 0;
-    while (std::filesystem::exists("assets/level" + std::to_string(maxLevel + 1) + ".txt")) {
-        ++maxLevel;
+namespace {
+    constexpr int snapshotWarmupTicks = 3; // One per triple-buffered snapshot
+
+    // The ring spans from just above the screen down to the paddle; only its upper half
+    // starts filled, so the ball has room when the game begins
+    constexpr int endlessRingRows = 22;
+    constexpr int endlessFilledRows = 11;
+    constexpr float endlessStartSpeed = 6.0f;
+    constexpr float endlessSpeedStep = 0.25f; // Added for every row that reaches the paddle
+    constexpr float endlessMaxSpeed = 30.0f;
+
+    LevelGeneratorParams endlessRowParams() {
+        LevelGeneratorParams params;
+        params.columns = 13;
+        params.density = 0.6f;
+        return params;
     }
-    std::cout << "Found " << maxLevel << " levels\n";
+}
+
+PlayingState::PlayingState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int startLevel)
+    : stateManager(sm), audioManager(am), highScoreManager(hsm), collisionSystem(sm.getWorkerPool()), gameplaySystems(am, sm.getRandom().stream(RandomStream::Gameplay)), stateChanged(false), isLevelComplete(false), currentLevel(startLevel) {
+    maxLevel = sm.getLevelCatalog().count();
     if (maxLevel == 0) {
-        throw std::runtime_error("No level files found in assets/");
+        throw std::runtime_error("No levels found in assets/");
+    }
+    if (startLevel == generatedLevelNumber) {
+        if (!stateManager.getGeneratedLevel()) {
+            throw std::runtime_error("No generated level to play");
+        }
     }
-    if (startLevel < 1 || startLevel > maxLevel) {
+    else if (startLevel != endlessLevelNumber && (startLevel < 1 || startLevel > maxLevel)) {
         throw std::runtime_error("Invalid start level: " + std::to_string(startLevel));
     }
 
     // Load the specified level
-    try {
-        config = loadLevelConfig("assets/level" + std::to_string(currentLevel) + ".txt");
-        std::cout << "Loaded level " << currentLevel << "\n";
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error loading level " << currentLevel << ": " << e.what() << "\n";
-        config = { 100, 300.0f, {} };
-    }
-
-    gameObjects.reset(config.paddleWidth, config.ballSpeed, config.levelLayout);
+    gameObjects.setWorkerPool(stateManager.getWorkerPool());
+    loadLevel(currentLevel);
+}
 
-    if (!font.loadFromFile("assets/arial.ttf")) {
+// Fonts and textures own GL objects, so they are created here on the main thread rather
+// than in the constructor, which may run on a prefetch thread
+void PlayingState::loadResources() {
+    if (resourcesLoaded) {
+        return;
+    }
+    if (!loadFont(font, "assets/arial.ttf")) {
         throw std::runtime_error("Failed to load font");
     }
-    stateManager.setcurrentLevel(currentLevel);
-    if (!backgroundTexture.loadFromFile("assets/background.png")) {
+    if (!loadTexture(backgroundTexture, "assets/background.png")) {
         throw std::runtime_error("Failed to load background texture");
     }
     backgroundSprite.setTexture(backgroundTexture);
@@ -52,184 +80,384 @@ PlayingState::PlayingState(GameStateManager& sm, AudioManager& am, HighScoreMana
     livesText.setFillColor(sf::Color::White);
     livesText.setPosition(700, 10);
 
-    pauseText.setFont(font);
-    pauseText.setString("Paused");
-    pauseText.setCharacterSize(50);
-    pauseText.setFillColor(sf::Color::White);
-    pauseText.setPosition(300, 150);
-
-    pauseOverlay.setSize({ 800, 600 });
-    pauseOverlay.setFillColor(sf::Color(0, 0, 0, 128));
-
-    resumeText.setFont(font);
-    resumeText.setString("Resume");
-    resumeText.setCharacterSize(30);
-    resumeText.setFillColor(sf::Color::White);
-    resumeText.setPosition(300, 250);
-
-    restartText.setFont(font);
-    restartText.setString("Restart");
-    restartText.setCharacterSize(30);
-    restartText.setFillColor(sf::Color::White);
-    restartText.setPosition(300, 300);
-
-    mainMenuText.setFont(font);
-    mainMenuText.setString("Main Menu");
-    mainMenuText.setCharacterSize(30);
-    mainMenuText.setFillColor(sf::Color::White);
-    mainMenuText.setPosition(300, 350);
-
-    exitText.setFont(font);
-    exitText.setString("Exit");
-    exitText.setCharacterSize(30);
-    exitText.setFillColor(sf::Color::White);
-    exitText.setPosition(300, 400);
-
-    levelCompleteText.setFont(font);
-    levelCompleteText.setString("Level " + std::to_string(currentLevel) + " Complete!");
-    levelCompleteText.setCharacterSize(50);
-    levelCompleteText.setFillColor(sf::Color::White);
-    levelCompleteText.setPosition(250, 150);
-
-    nextLevelText.setFont(font);
-    nextLevelText.setString("Next Level");
-    nextLevelText.setCharacterSize(30);
-    nextLevelText.setFillColor(sf::Color::White);
-    nextLevelText.setPosition(300, 250);
+    createOverlays();
+    resourcesLoaded = true;
 }
 
-void PlayingState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
-    if (event.type == sf::Event::Closed) {
-        window.close();
+// The constructor may run on a prefetch thread and its result may be discarded, so
+// anything that touches shared session state waits until the state is actually entered
+void PlayingState::onEnter() {
+    loadResources();
+    stateManager.setcurrentLevel(currentLevel);
+    restartGameplayRandom();
+    watchLevelFile();
+    if (stateManager.getLaunchOptions().threadedSimulation && !simulationThread.joinable()) {
+        startSimulationThread();
     }
-    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape && !isLevelComplete) {
-        isPaused = !isPaused;
-    }
-    sf::Vector2f mousePos;
-    if (event.type == sf::Event::MouseMoved && (isPaused || isLevelComplete)) {
-        mousePos = window.mapPixelToCoords(sf::Vector2i(event.mouseMove.x, event.mouseMove.y));
-        // Aktualizuj kolory przycisków podczas ruchu myszy
-        if (isPaused) {
-            resumeText.setFillColor(resumeText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
-            restartText.setFillColor(restartText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
-            mainMenuText.setFillColor(mainMenuText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
-            exitText.setFillColor(exitText.getGlobalBounds().contains(mousePos) ? sf::Color::Red : sf::Color::White);
+}
+
+namespace {
+    // Writes "label value" into text without building temporary strings
+    void formatHudText(sf::String& text, const char* label, int value) {
+        char digits[16];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        text.clear();
+        for (const char* c = label; *c; ++c) {
+            text += sf::String(static_cast<sf::Uint32>(*c));
         }
-        else if (isLevelComplete) {
-            nextLevelText.setFillColor((currentLevel < maxLevel && nextLevelText.getGlobalBounds().contains(mousePos)) ? sf::Color::Green : (currentLevel < maxLevel ? sf::Color::White : sf::Color(128, 128, 128)));
-            restartText.setFillColor(restartText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
-            mainMenuText.setFillColor(mainMenuText.getGlobalBounds().contains(mousePos) ? sf::Color::Green : sf::Color::White);
-            exitText.setFillColor(exitText.getGlobalBounds().contains(mousePos) ? sf::Color::Red : sf::Color::White);
+        for (const char* c = digits; c != result.ptr; ++c) {
+            text += sf::String(static_cast<sf::Uint32>(*c));
         }
     }
-    else if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left && (isPaused || isLevelComplete)) {
-        mousePos = window.mapPixelToCoords(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
-        std::cout << "Mouse clicked at (" << mousePos.x << ", " << mousePos.y << ")\n";
 
-        if (isPaused) {
-            if (resumeText.getGlobalBounds().contains(mousePos)) {
-                std::cout << "Resume clicked\n";
-                isPaused = false;
-            }
-            else if (restartText.getGlobalBounds().contains(mousePos)) {
-                std::cout << "Restart clicked for level " << currentLevel << "\n";
-                stateManager.setState<PlayingState>(stateManager, audioManager, highScoreManager, currentLevel);
-            }
-            else if (mainMenuText.getGlobalBounds().contains(mousePos)) {
-                std::cout << "Main Menu clicked\n";
-                stateManager.setState<MenuState>(stateManager, audioManager, highScoreManager);
-            }
-            else if (exitText.getGlobalBounds().contains(mousePos)) {
-                std::cout << "Exit clicked\n";
-                window.close();
-            }
+    std::string prefetchKey(int level) {
+        return "level:" + std::to_string(level);
+    }
+}
+
+void PlayingState::prefetch(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int level) {
+    // A generated layout can be replaced while the prefetch runs, so it never qualifies
+    if (level == generatedLevelNumber) {
+        return;
+    }
+    // The ball sprites share cached textures; creating them now keeps the prefetch
+    // thread from being the first to touch them
+    getSharedTexture("assets/ball.png");
+    getSharedTexture("assets/bonus_ball.png");
+    sm.prefetchState(prefetchKey(level), [&sm, &am, &hsm, level] {
+        return std::make_unique<PlayingState>(sm, am, hsm, level);
+    });
+}
+
+void PlayingState::start(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int level) {
+    if (!sm.commitPrefetchedState(prefetchKey(level))) {
+        sm.setState<PlayingState>(sm, am, hsm, level);
+    }
+}
+
+PlayingState::~PlayingState() {
+    stopSimulationThread();
+}
+
+void PlayingState::handleEvents(sf::RenderWindow& window, sf::Event& event) {
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape && !isLevelComplete && !isPaused) {
+        isPaused = true;
+        stateManager.pushState(*pauseMenu);
+    }
+}
+
+void PlayingState::update(float deltaTime) {
+    if (stateChanged) {
+        return;
+    }
+    if (levelWatcher.poll()) {
+        reloadLevelLayout();
+    }
+    if (!stateManager.getLaunchOptions().threadedSimulation) {
+        simulate(deltaTime);
+    }
+
+    if (isLevelComplete && !levelCompleteHandled) {
+        levelCompleteHandled = true;
+        audioManager.playDestroySound();
+        int score = 0;
+        {
+            std::scoped_lock lock(simulationMutex);
+            score = gameObjects.getScore();
         }
-        else if (isLevelComplete) {
-            if (currentLevel < maxLevel && nextLevelText.getGlobalBounds().contains(mousePos)) {
-                std::cout << "Next Level clicked\n";
-                currentLevel++;
-                stateManager.setcurrentLevel(currentLevel);
-                try {
-                    config = loadLevelConfig("assets/level" + std::to_string(currentLevel) + ".txt");
-                    std::cout << "Loaded level " << currentLevel << "\n";
-                }
-                catch (const std::exception& e) {
-                    std::cerr << "Error loading level " << currentLevel << ": " << e.what() << "\n";
-                    config = { 100, 300.0f, {} };
-                }
-                gameObjects.reset(config.paddleWidth, config.ballSpeed, config.levelLayout);
-                lives = 3;
-                isLevelComplete = false;
-                levelCompleteText.setString("Level " + std::to_string(currentLevel) + " Complete!");
-            }
-            else if (restartText.getGlobalBounds().contains(mousePos)) {
-                std::cout << "Restart clicked for level " << currentLevel << "\n";
-                stateManager.setState<PlayingState>(stateManager, audioManager, highScoreManager, currentLevel);
-            }
-            else if (mainMenuText.getGlobalBounds().contains(mousePos)) {
-                std::cout << "Main Menu clicked\n";
-                stateManager.setState<MenuState>(stateManager, audioManager, highScoreManager);
-            }
-            else if (exitText.getGlobalBounds().contains(mousePos)) {
-                std::cout << "Exit clicked\n";
-                window.close();
-            }
+        // Generated layouts differ between runs, so their scores stay off the leaderboard
+        if (isCampaignLevel()) {
+            highScoreManager.addScore(stateManager.getNickname(), score, currentLevel);
+        }
+        std::cout << "Level " << currentLevel << " completed\n";
+        if (config.parScore > 0) {
+            std::cout << "Score " << score << ", par " << config.parScore << "\n";
         }
+        std::string levelName = !config.name.empty() ? config.name
+            : currentLevel == generatedLevelNumber ? "Level" : "Level " + std::to_string(currentLevel);
+        levelCompleteMenu->setTitle(levelName + " Complete!");
+        levelCompleteMenu->setButtonEnabled(0, hasNextLevel());
+        stateManager.pushState(*levelCompleteMenu);
+        return;
+    }
+
+    if (isGameOver) {
+        stopSimulationThread();
+        stateChanged = true;
+        stateManager.showState<GameOverState>(stateManager, audioManager, highScoreManager).setFinalScore(gameObjects.getScore());
+        return;
     }
 }
 
-void PlayingState::update(float deltaTime) {
-    if (isPaused || isLevelComplete || stateChanged) {
+void PlayingState::draw(sf::RenderWindow& window) {
+    window.draw(backgroundSprite);
+    snapshots.fetch();
+    const WorldSnapshot& snapshot = snapshots.readBuffer();
+    snapshotRenderer.draw(window, snapshot);
+    TraceScope scope("DrawHud", "render");
+    AllocationZone allocationZone("DrawHud");
+    if (snapshot.score != displayedScore) {
+        displayedScore = snapshot.score;
+        formatHudText(hudString, "Score: ", displayedScore);
+        scoreText.setString(hudString);
+    }
+    if (snapshot.lives != displayedLives) {
+        displayedLives = snapshot.lives;
+        formatHudText(hudString, "Lives: ", displayedLives);
+        livesText.setString(hudString);
+    }
+    window.draw(scoreText);
+    window.draw(livesText);
+}
+
+// The simulation thread keeps its tick loop but skips simulate() while an overlay is on top
+void PlayingState::onPause() {
+    isPaused = true;
+}
+
+void PlayingState::onResume() {
+    isPaused = false;
+}
+
+void PlayingState::restartLevel() {
+    std::cout << "Restarting level " << currentLevel << "\n";
+    std::scoped_lock lock(simulationMutex);
+    loadLevel(currentLevel);
+    restartGameplayRandom();
+    isLevelComplete = false;
+    levelCompleteHandled = false;
+    isGameOver = false;
+}
+
+void PlayingState::nextLevel() {
+    std::scoped_lock lock(simulationMutex);
+    currentLevel++;
+    stateManager.setcurrentLevel(currentLevel);
+    loadLevel(currentLevel);
+    restartGameplayRandom();
+    watchLevelFile();
+    isLevelComplete = false;
+    levelCompleteHandled = false;
+}
+
+void PlayingState::watchLevelFile() {
+    std::string path = isCampaignLevel() ? stateManager.getLevelCatalog().filePath(currentLevel) : "";
+    if (!stateManager.getLaunchOptions().watchLevels || path.empty()) {
+        levelWatcher.stop();
         return;
     }
+    levelWatcher.watch(path);
+    std::cout << "Watching " << path << " for changes\n";
+}
+
+// Applies an edited level file to the running game: only cells whose character changed are
+// rebuilt, and the paddle, balls, score and lives are left alone
+void PlayingState::reloadLevelLayout() {
+    try {
+        LevelConfig edited = loadLevelConfig(levelWatcher.getPath());
+        auto start = std::chrono::steady_clock::now();
+        int rebuilt = 0;
+        {
+            std::scoped_lock lock(simulationMutex);
+            rebuilt = gameObjects.applyLayoutChanges(edited.layout);
+            config.layout = std::move(edited.layout);
+            warmupTicks = snapshotWarmupTicks;
+            publishSnapshot();
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Reloaded " << levelWatcher.getPath() << ": " << rebuilt << " cells rebuilt in " << elapsed << " ms\n";
+    }
+    catch (const std::exception& e) {
+        // Typically a half-written file; the next save triggers another attempt
+        std::cerr << "Hot reload of " << levelWatcher.getPath() << " failed: " << e.what() << "\n";
+    }
+}
+
+// Every attempt at a level sees the same bonus drops for a given session seed
+void PlayingState::restartGameplayRandom() {
+    stateManager.getRandom().restartStream(RandomStream::Gameplay, static_cast<std::uint64_t>(currentLevel));
+}
+
+void PlayingState::createOverlays() {
+    auto mainMenu = [this](sf::RenderWindow&) {
+        stateManager.showState<MenuState>(stateManager, audioManager, highScoreManager);
+    };
+    auto restart = [this](sf::RenderWindow&) {
+        restartLevel();
+        stateManager.popState();
+    };
+    auto exit = [](sf::RenderWindow& window) {
+        window.close();
+    };
+    auto resume = [this](sf::RenderWindow&) {
+        stateManager.popState();
+    };
+
+    pauseMenu = std::make_unique<OverlayMenuState>(font, "Paused", sf::Vector2f(300, 150));
+    pauseMenu->addButton("Resume", sf::Color::Green, resume);
+    pauseMenu->addButton("Restart", sf::Color::Green, restart);
+    pauseMenu->addButton("Main Menu", sf::Color::Green, mainMenu);
+    pauseMenu->addButton("Exit", sf::Color::Red, exit);
+    pauseMenu->setEscapeAction(resume);
+
+    levelCompleteMenu = std::make_unique<OverlayMenuState>(font, "Level Complete!", sf::Vector2f(250, 150));
+    levelCompleteMenu->addButton("Next Level", sf::Color::Green, [this](sf::RenderWindow&) {
+        nextLevel();
+        stateManager.popState();
+    });
+    levelCompleteMenu->addButton("Restart", sf::Color::Green, restart);
+    levelCompleteMenu->addButton("Main Menu", sf::Color::Green, mainMenu);
+    levelCompleteMenu->addButton("Exit", sf::Color::Red, exit);
+}
+
+// One simulation tick; runs on the simulation thread when threaded mode is enabled
+void PlayingState::simulate(float deltaTime) {
+    TraceScope scope("Simulate", "sim");
+    AllocationZone allocationZone("Simulate");
+    if (isPaused || isLevelComplete || isGameOver) {
+        return;
+    }
+    // The first ticks after a level is built size the snapshot and scratch buffers; every
+    // tick after that must run without touching the heap
+    // Refilling an endless row rebuilds the shared block layout, so it happens before the
+    // zero-allocation scope opens
+    if (currentLevel == endlessLevelNumber) {
+        scrollEndlessField(deltaTime);
+    }
+    std::optional<ZeroAllocationScope> steadyState;
+    if (warmupTicks > 0) {
+        --warmupTicks;
+    }
+    else {
+        steadyState.emplace("SimulateSteadyState");
+    }
     gameObjects.update(deltaTime);
-    collisionSystem.checkCollisions(gameObjects);
+    gameplayEvents.clear();
+    collisionSystem.checkCollisions(gameObjects, gameplayEvents);
+    gameplaySystems.process(gameplayEvents, gameObjects);
 
     if (gameObjects.allDestructibleBlocksDestroyed()) {
         isLevelComplete = true;
-        audioManager.playDestroySound();
-        highScoreManager.addScore(stateManager.getNickname(), gameObjects.getScore(),currentLevel);
-        std::cout << "Level " << currentLevel << " completed\n";
+        publishSnapshot();
         return;
     }
 
     auto ball = gameObjects.getBall();
     if (ball && ball->isOutOfBounds()) {
+        recordNote("BallLost, lives left", static_cast<float>(lives - 1));
         if (--lives <= 0) {
-            stateManager.setState<GameOverState>(stateManager, audioManager, highScoreManager, gameObjects.getScore());
-            stateChanged = true;
-            return;
+            isGameOver = true;
         }
         else {
             ball->reset(400, 300);
         }
     }
+    publishSnapshot();
+}
 
-    scoreText.setString("Score: " + std::to_string(gameObjects.getScore()));
-    livesText.setString("Lives: " + std::to_string(lives));
+void PlayingState::publishSnapshot() {
+    WorldSnapshot& snapshot = snapshots.writeBuffer();
+    gameObjects.captureSnapshot(snapshot);
+    snapshot.lives = lives;
+    int aliveBlocks = 0;
+    for (auto hits : snapshot.blockHits) {
+        aliveBlocks += hits > 0;
+    }
+    recordEntityCounts(static_cast<int>(snapshot.balls.size()), static_cast<int>(snapshot.bonuses.size()), aliveBlocks);
+    snapshots.publish();
 }
 
-void PlayingState::draw(sf::RenderWindow& window) {
-    window.clear(sf::Color::Black);
-    window.draw(backgroundSprite);
-    gameObjects.draw(window);
-    window.draw(scoreText);
-    window.draw(livesText);
-    if (isPaused) {
-        window.draw(pauseOverlay);
-        window.draw(pauseText);
-        window.draw(resumeText);
-        window.draw(restartText);
-        window.draw(mainMenuText);
-        window.draw(exitText);
-    }
-    else if (isLevelComplete) {
-        window.draw(pauseOverlay);
-        window.draw(levelCompleteText);
-        window.draw(nextLevelText);
-        window.draw(restartText);
-        window.draw(mainMenuText);
-        window.draw(exitText);
-    }
-    window.display();
-}
\ No newline at end of file
+void PlayingState::loadLevel(int level) {
+    recordNote("LoadLevel", static_cast<float>(level));
+    if (level == endlessLevelNumber) {
+        config = LevelConfig{};
+        config.name = "Endless";
+    }
+    else if (level == generatedLevelNumber) {
+        config = *stateManager.getGeneratedLevel();
+    }
+    else {
+        try {
+            config = stateManager.getLevelCatalog().load(level);
+            std::cout << "Loaded level " << level << "\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error loading level " << level << ": " << e.what() << "\n";
+            config = LevelConfig{};
+        }
+    }
+    if (level == endlessLevelNumber) {
+        buildEndlessField();
+    }
+    else {
+        gameObjects.reset(config.paddleWidth, config.ballSpeed, config.layout);
+    }
+    if (stateManager.getLaunchOptions().stressBalls > 0) {
+        gameObjects.spawnStressBalls(stateManager.getLaunchOptions().stressBalls, config.ballSpeed);
+    }
+    lives = 3;
+    warmupTicks = snapshotWarmupTicks;
+    publishSnapshot();
+}
+
+// Every attempt sees the same rows for a given session seed
+void PlayingState::buildEndlessField() {
+    LevelGeneratorParams params = endlessRowParams();
+    endlessRandom.seed(stateManager.getRandom().getSessionSeed());
+    LevelGrid rows;
+    rows.rows = endlessRingRows;
+    rows.columns = params.columns;
+    rows.cells.assign(rows.rows * rows.columns, LevelCell{});
+    for (size_t row = 0; row < endlessFilledRows; ++row) {
+        generateRow(endlessRandom, params, &rows.at(row, 0));
+    }
+    gameObjects.resetEndless(config.paddleWidth, config.ballSpeed, rows);
+    endlessRow.assign(rows.columns, LevelCell{});
+    endlessScrollSpeed = endlessStartSpeed;
+}
+
+void PlayingState::scrollEndlessField(float deltaTime) {
+    gameObjects.scrollBlocks(endlessScrollSpeed * deltaTime);
+    while (gameObjects.lowestRowReachedPaddle()) {
+        generateRow(endlessRandom, endlessRowParams(), endlessRow.data());
+        gameObjects.recycleLowestRow(endlessRow.data());
+        endlessScrollSpeed = std::min(endlessMaxSpeed, endlessScrollSpeed + endlessSpeedStep);
+    }
+}
+
+bool PlayingState::isCampaignLevel() const {
+    return currentLevel >= 1;
+}
+
+bool PlayingState::hasNextLevel() const {
+    return isCampaignLevel() && currentLevel < maxLevel;
+}
+
+void PlayingState::startSimulationThread() {
+    simulationThread = std::jthread([this](std::stop_token stopToken) {
+        nameTraceThread("Simulation");
+        constexpr auto tick = std::chrono::microseconds(1000000 / 120);
+        constexpr float tickSeconds = 1.0f / 120.0f;
+        auto nextTick = std::chrono::steady_clock::now();
+        while (!stopToken.stop_requested()) {
+            {
+                std::scoped_lock lock(simulationMutex);
+                simulate(tickSeconds);
+            }
+            nextTick += tick;
+            auto now = std::chrono::steady_clock::now();
+            if (nextTick < now) {
+                nextTick = now; // Skip missed ticks after a stall instead of catching up
+            }
+            std::this_thread::sleep_until(nextTick);
+        }
+    });
+    std::cout << "Simulation thread started\n";
+}
+
+void PlayingState::stopSimulationThread() {
+    if (simulationThread.joinable()) {
+        simulationThread.request_stop();
+        simulationThread.join();
+    }
+}
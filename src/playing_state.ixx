@@ -1,45 +1,97 @@
 export module playing_state;
 
 import <SFML/Graphics.hpp>;
+import <atomic>;
+import <mutex>;
+import <thread>;
 import game_state;
 import game_state_manager;
 import game_object_manager;
 import collision_system;
+import gameplay_events;
+import gameplay_systems;
 import audio;
 import highscore;
 import config;
+import world_snapshot;
+import overlay_menu_state;
+import file_watcher;
+import random_service;
+import <memory>;
 
 export class PlayingState : public GameState {
 public:
     PlayingState(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int startLevel = 1);
+    ~PlayingState() override;
     int FcurrentLevel();
     void handleEvents(sf::RenderWindow& window, sf::Event& event) override;
     void update(float deltaTime) override;
     void draw(sf::RenderWindow& window) override;
+    void onEnter() override;
+    void onPause() override;
+    void onResume() override;
+    // Reloads the current level in place instead of constructing a new state
+    void restartLevel();
+
+    // Starts building the state for a campaign level or endless mode in the background
+    static void prefetch(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int level);
+    // Switches to the level, using a matching prefetch when one exists
+    static void start(GameStateManager& sm, AudioManager& am, HighScoreManager& hsm, int level);
 private:
     GameObjectManager gameObjects;
     CollisionSystem collisionSystem;
+    GameplayEventQueue gameplayEvents;
+    GameplaySystems gameplaySystems;
     GameStateManager& stateManager;
     AudioManager& audioManager;
     HighScoreManager& highScoreManager;
     LevelConfig config;
     int lives = 3;
-    bool isPaused = false;
+    std::atomic<bool> isPaused = false;
     bool stateChanged = false;
-    bool isLevelComplete = false;
+    std::atomic<bool> isLevelComplete = false;
+    std::atomic<bool> isGameOver = false;
+    bool levelCompleteHandled = false;
     int maxLevel = 3;
     int currentLevel = 1;
+    bool resourcesLoaded = false;
     sf::Font font;
     sf::Text scoreText;
     sf::Text livesText;
-    sf::Text pauseText;
-    sf::RectangleShape pauseOverlay;
-    sf::Text resumeText;
-    sf::Text restartText;
-    sf::Text mainMenuText;
-    sf::Text exitText;
-    sf::Text levelCompleteText;
-    sf::Text nextLevelText;
     sf::Texture backgroundTexture;
     sf::Sprite backgroundSprite;
-};
\ No newline at end of file
+    // Overlays pushed on top of this state; they live as long as it does
+    std::unique_ptr<OverlayMenuState> pauseMenu;
+    std::unique_ptr<OverlayMenuState> levelCompleteMenu;
+
+    // Simulation publishes snapshots, draw() only ever reads them
+    TripleBuffer<WorldSnapshot> snapshots;
+    SnapshotRenderer snapshotRenderer;
+    int displayedScore = -1;
+    int displayedLives = -1;
+    sf::String hudString; // Reused for every HUD update so it keeps its capacity
+    int warmupTicks = 0;  // Ticks left before simulate() is held to zero allocations
+    std::mutex simulationMutex;
+    std::jthread simulationThread;
+    FileWatcher levelWatcher;
+    // Endless mode draws its rows from its own stream, so they never shift the bonus drops
+    Xoshiro256 endlessRandom;
+    std::vector<LevelCell> endlessRow;
+    float endlessScrollSpeed = 0.0f; // Pixels per second
+
+    void simulate(float deltaTime);
+    void publishSnapshot();
+    void loadLevel(int level);
+    void buildEndlessField();
+    void scrollEndlessField(float deltaTime);
+    bool isCampaignLevel() const;
+    bool hasNextLevel() const;
+    void nextLevel();
+    void loadResources();
+    void createOverlays();
+    void restartGameplayRandom();
+    void watchLevelFile();
+    void reloadLevelLayout();
+    void startSimulationThread();
+    void stopSimulationThread();
+};
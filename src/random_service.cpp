@@ -0,0 +1,79 @@
+module random_service;
+
+import <random>;
+import <stdexcept>;
+
+namespace {
+    // splitmix64, the recommended way to expand one 64-bit seed into xoshiro state
+    std::uint64_t splitMix(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    std::uint64_t streamSeed(std::uint64_t sessionSeed, RandomStream which, std::uint64_t salt) {
+        std::uint64_t x = sessionSeed ^ (static_cast<std::uint64_t>(which) << 56);
+        std::uint64_t mixed = splitMix(x);
+        x = mixed ^ salt;
+        return splitMix(x);
+    }
+}
+
+Xoshiro256::Xoshiro256(std::uint64_t seed) {
+    this->seed(seed);
+}
+
+void Xoshiro256::seed(std::uint64_t seed) {
+    for (auto& word : state) {
+        word = splitMix(seed);
+    }
+}
+
+int Xoshiro256::uniformInt(int min, int max) {
+    if (min > max) {
+        throw std::invalid_argument("uniformInt: min must not exceed max");
+    }
+    // Lemire's multiply-shift with rejection; unbiased and division-free in the common case
+    std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min) + 1;
+    std::uint64_t x = (*this)() >> 32;
+    std::uint64_t m = x * range;
+    std::uint64_t low = m & 0xFFFFFFFFull;
+    if (low < range) {
+        std::uint64_t threshold = (0x100000000ull - range) % range;
+        while (low < threshold) {
+            x = (*this)() >> 32;
+            m = x * range;
+            low = m & 0xFFFFFFFFull;
+        }
+    }
+    return static_cast<int>(min + static_cast<std::int64_t>(m >> 32));
+}
+
+float Xoshiro256::uniformFloat() {
+    return static_cast<float>((*this)() >> 40) * (1.0f / 16777216.0f);
+}
+
+RandomService::RandomService(std::uint64_t sessionSeed)
+    : sessionSeed(sessionSeed) {
+    for (std::size_t i = 0; i < streams.size(); ++i) {
+        restartStream(static_cast<RandomStream>(i), 0);
+    }
+}
+
+std::uint64_t RandomService::getSessionSeed() const {
+    return sessionSeed;
+}
+
+Xoshiro256& RandomService::stream(RandomStream which) {
+    return streams[static_cast<std::size_t>(which)];
+}
+
+void RandomService::restartStream(RandomStream which, std::uint64_t salt) {
+    stream(which).seed(streamSeed(sessionSeed, which, salt));
+}
+
+std::uint64_t RandomService::randomSeed() {
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+}
@@ -0,0 +1,70 @@
+export module random_service;
+
+import <array>;
+import <cstddef>;
+import <cstdint>;
+import <limits>;
+
+// xoshiro256** (Blackman & Vigna). 32 bytes of state and a few instructions per number,
+// and unlike the standard distributions the helpers below give the same sequence on
+// every compiler, so a seed fully describes a session.
+export class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed = 0);
+    void seed(std::uint64_t seed);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [min, max]
+    int uniformInt(int min, int max);
+    // Uniform in [0, 1)
+    float uniformFloat();
+
+private:
+    std::array<std::uint64_t, 4> state{};
+
+    static constexpr std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+// Subsystems draw from separate streams so that, for example, generating a level never
+// shifts which bonus the next block drops
+export enum class RandomStream {
+    Gameplay,  // Bonus drops; restarted per level
+    Generator, // Seeds for levels generated from the menu
+    Count
+};
+
+export class RandomService {
+public:
+    explicit RandomService(std::uint64_t sessionSeed);
+
+    std::uint64_t getSessionSeed() const;
+    Xoshiro256& stream(RandomStream which);
+    // Restarts one stream from the session seed and a salt (e.g. the level number), so
+    // that stream replays identically no matter what happened earlier in the session
+    void restartStream(RandomStream which, std::uint64_t salt);
+
+    // Non-deterministic seed for sessions started without --seed
+    static std::uint64_t randomSeed();
+
+private:
+    std::uint64_t sessionSeed;
+    std::array<Xoshiro256, static_cast<std::size_t>(RandomStream::Count)> streams;
+};
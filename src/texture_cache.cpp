@@ -0,0 +1,23 @@
+module texture_cache;
+
+import asset_pack;
+import <map>;
+import <memory>;
+import <mutex>;
+import <stdexcept>;
+
+const sf::Texture& getSharedTexture(const std::string& path) {
+    static std::mutex mutex;
+    static std::map<std::string, std::unique_ptr<sf::Texture>> textures;
+
+    std::scoped_lock lock(mutex);
+    auto it = textures.find(path);
+    if (it != textures.end()) {
+        return *it->second;
+    }
+    auto texture = std::make_unique<sf::Texture>();
+    if (!loadTexture(*texture, path)) {
+        throw std::runtime_error("Failed to load texture: " + path);
+    }
+    return *textures.emplace(path, std::move(texture)).first->second;
+}
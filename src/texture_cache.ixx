@@ -0,0 +1,7 @@
+export module texture_cache;
+
+import <SFML/Graphics.hpp>;
+import <string>;
+
+// Returns a texture that stays alive for the whole program; each file is loaded only once
+export const sf::Texture& getSharedTexture(const std::string& path);
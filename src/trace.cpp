@@ -0,0 +1,138 @@
+module trace;
+
+import <array>;
+import <cstdlib>;
+import <fstream>;
+import <iostream>;
+import <memory>;
+import <mutex>;
+import <vector>;
+
+namespace {
+    struct TraceEvent {
+        const char* name;
+        const char* category;
+        std::int64_t startUs;
+        std::int64_t durationUs;
+    };
+
+    constexpr std::size_t chunkSize = 4096;
+    constexpr std::size_t maxChunks = 1024; // About four million events per thread
+
+    struct Chunk {
+        std::array<TraceEvent, chunkSize> events;
+    };
+
+    // Chunks bypass operator new, so tracing does not count against zero-allocation zones
+    struct ChunkDeleter {
+        void operator()(Chunk* chunk) const { std::free(chunk); }
+    };
+
+    // Only the owning thread writes. An event becomes visible to the exporter when count is
+    // published, so chunks are never resized or moved while another thread might read them.
+    struct ThreadBuffer {
+        int threadId = 0;
+        std::atomic<const char*> threadName{ nullptr };
+        std::array<std::unique_ptr<Chunk, ChunkDeleter>, maxChunks> chunks;
+        std::atomic<std::size_t> count{ 0 };
+        std::atomic<std::size_t> dropped{ 0 };
+    };
+
+    std::chrono::steady_clock::time_point traceStart = std::chrono::steady_clock::now();
+    // Only taken the first time a thread records an event, and by the exporter
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+    ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            std::scoped_lock lock(registryMutex);
+            registry.push_back(std::make_unique<ThreadBuffer>());
+            buffer = registry.back().get();
+            buffer->threadId = static_cast<int>(registry.size());
+        }
+        return *buffer;
+    }
+
+    void writeEvents(std::ostream& out) {
+        std::scoped_lock lock(registryMutex);
+        bool first = true;
+        auto separator = [&] {
+            out << (first ? "\n" : ",\n");
+            first = false;
+        };
+        for (const auto& buffer : registry) {
+            if (const char* name = buffer->threadName.load(std::memory_order_acquire)) {
+                separator();
+                out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->threadId
+                    << R"(,"args":{"name":")" << name << R"("}})";
+            }
+            std::size_t count = buffer->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; ++i) {
+                const TraceEvent& event = buffer->chunks[i / chunkSize]->events[i % chunkSize];
+                separator();
+                out << R"({"name":")" << event.name << R"(","cat":")" << event.category
+                    << R"(","ph":"X","ts":)" << event.startUs << R"(,"dur":)" << event.durationUs
+                    << R"(,"pid":1,"tid":)" << buffer->threadId << "}";
+            }
+            if (std::size_t dropped = buffer->dropped.load(std::memory_order_relaxed)) {
+                std::cerr << "Trace: thread " << buffer->threadId << " dropped " << dropped << " events\n";
+            }
+        }
+    }
+}
+
+std::int64_t traceClockMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - traceStart).count();
+}
+
+void recordTraceEvent(const char* name, const char* category, std::int64_t startUs, std::int64_t endUs) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::size_t index = buffer.count.load(std::memory_order_relaxed);
+    std::size_t chunk = index / chunkSize;
+    if (chunk >= maxChunks) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (!buffer.chunks[chunk]) {
+        buffer.chunks[chunk].reset(static_cast<Chunk*>(std::malloc(sizeof(Chunk))));
+        if (!buffer.chunks[chunk]) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    buffer.chunks[chunk]->events[index % chunkSize] = { name, category, startUs, endUs - startUs };
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void nameTraceThread(const char* name) {
+    if (isTracing()) {
+        threadBuffer().threadName.store(name, std::memory_order_release);
+    }
+}
+
+TraceSession::TraceSession(const std::string& path)
+    : path(path) {
+    if (path.empty()) {
+        return;
+    }
+    traceStart = std::chrono::steady_clock::now();
+    tracingActive = true;
+    std::cout << "Tracing to " << path << "\n";
+}
+
+TraceSession::~TraceSession() {
+    if (path.empty()) {
+        return;
+    }
+    tracingActive = false;
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open trace file: " << path << "\n";
+        return;
+    }
+    file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+    writeEvents(file);
+    file << "\n]}\n";
+    std::cout << "Trace written to " << path << "\n";
+}
@@ -0,0 +1,51 @@
+export module trace;
+
+import <atomic>;
+import <chrono>;
+import <cstdint>;
+import <string>;
+
+// Timeline recorder that writes the Chrome trace event format (chrome://tracing, Perfetto).
+// Every thread appends to its own buffer without locking; buffers are written out when the
+// TraceSession ends. Names and categories must be string literals.
+
+std::atomic<bool> tracingActive{ false };
+
+export std::int64_t traceClockMicroseconds();
+export void recordTraceEvent(const char* name, const char* category, std::int64_t startUs, std::int64_t endUs);
+// Labels the calling thread in the viewer
+export void nameTraceThread(const char* name);
+
+export inline bool isTracing() {
+    return tracingActive.load(std::memory_order_relaxed);
+}
+
+// Records the lifetime of the scope as one complete event; does nothing while not tracing
+export class TraceScope {
+public:
+    TraceScope(const char* name, const char* category)
+        : name(name), category(category), startUs(isTracing() ? traceClockMicroseconds() : -1) {}
+    ~TraceScope() {
+        if (startUs >= 0) {
+            recordTraceEvent(name, category, startUs, traceClockMicroseconds());
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+private:
+    const char* name;
+    const char* category;
+    std::int64_t startUs;
+};
+
+// Enables tracing for its lifetime when given a path, and writes the file when destroyed.
+// Create it before any thread that may record events and let it outlive them.
+export class TraceSession {
+public:
+    explicit TraceSession(const std::string& path);
+    ~TraceSession();
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+private:
+    std::string path;
+};
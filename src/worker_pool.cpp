@@ -0,0 +1,80 @@
+module worker_pool;
+
+import <algorithm>;
+import trace;
+
+WorkerPool::WorkerPool(unsigned workerCount) {
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::scoped_lock lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    workers.clear();
+}
+
+unsigned WorkerPool::concurrency() const {
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+void WorkerPool::parallelFor(std::size_t count, const std::function<void(std::size_t begin, std::size_t end)>& body) {
+    if (count == 0) {
+        return;
+    }
+    if (workers.empty() || count == 1) {
+        body(0, count);
+        return;
+    }
+
+    std::unique_lock lock(mutex);
+    currentBody = &body;
+    currentCount = count;
+    chunkCount = std::min<std::size_t>(count, concurrency());
+    nextChunk = 0;
+    finishedChunks = 0;
+    ++generation;
+    wakeWorkers.notify_all();
+
+    while (runNextChunk(lock)) {}
+    chunksDone.wait(lock, [this] { return finishedChunks == chunkCount; });
+    currentBody = nullptr;
+}
+
+void WorkerPool::workerLoop() {
+    nameTraceThread("Worker");
+    std::unique_lock lock(mutex);
+    std::size_t seenGeneration = 0;
+    while (true) {
+        wakeWorkers.wait(lock, [&] { return stopping || generation != seenGeneration; });
+        if (stopping) {
+            return;
+        }
+        seenGeneration = generation;
+        while (runNextChunk(lock)) {}
+    }
+}
+
+// Called with the lock held; releases it while the chunk body runs
+bool WorkerPool::runNextChunk(std::unique_lock<std::mutex>& lock) {
+    if (!currentBody || nextChunk >= chunkCount) {
+        return false;
+    }
+    std::size_t chunk = nextChunk++;
+    std::size_t begin = currentCount * chunk / chunkCount;
+    std::size_t end = currentCount * (chunk + 1) / chunkCount;
+    auto body = currentBody;
+
+    lock.unlock();
+    (*body)(begin, end);
+    lock.lock();
+
+    if (++finishedChunks == chunkCount) {
+        chunksDone.notify_all();
+    }
+    return true;
+}
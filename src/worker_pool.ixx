@@ -0,0 +1,38 @@
+export module worker_pool;
+
+import <condition_variable>;
+import <cstddef>;
+import <functional>;
+import <mutex>;
+import <thread>;
+import <vector>;
+
+// Fixed set of worker threads for data-parallel loops. The calling thread takes part in
+// every loop, so a pool of N threads runs work on N + 1 cores.
+export class WorkerPool {
+public:
+    explicit WorkerPool(unsigned workerCount);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Splits [0, count) into contiguous chunks and blocks until all of them are done.
+    // Chunk boundaries depend only on count and the pool size.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t begin, std::size_t end)>& body);
+    unsigned concurrency() const;
+private:
+    std::vector<std::jthread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable chunksDone;
+    const std::function<void(std::size_t, std::size_t)>* currentBody = nullptr;
+    std::size_t currentCount = 0;
+    std::size_t chunkCount = 0;
+    std::size_t nextChunk = 0;
+    std::size_t finishedChunks = 0;
+    std::size_t generation = 0;
+    bool stopping = false;
+
+    void workerLoop();
+    bool runNextChunk(std::unique_lock<std::mutex>& lock);
+};
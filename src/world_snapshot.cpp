@@ -0,0 +1,96 @@
+module world_snapshot;
+
+import texture_cache;
+import trace;
+
+namespace {
+    constexpr float outlineThickness = 2.0f;
+
+    void appendQuad(sf::VertexArray& vertices, sf::FloatRect rect, sf::Color color) {
+        sf::Vector2f topLeft(rect.left, rect.top);
+        sf::Vector2f topRight(rect.left + rect.width, rect.top);
+        sf::Vector2f bottomRight(rect.left + rect.width, rect.top + rect.height);
+        sf::Vector2f bottomLeft(rect.left, rect.top + rect.height);
+        vertices.append(sf::Vertex(topLeft, color));
+        vertices.append(sf::Vertex(topRight, color));
+        vertices.append(sf::Vertex(bottomRight, color));
+        vertices.append(sf::Vertex(topLeft, color));
+        vertices.append(sf::Vertex(bottomRight, color));
+        vertices.append(sf::Vertex(bottomLeft, color));
+    }
+
+    void setupBallSprite(sf::Sprite& sprite, const sf::Texture& texture) {
+        sprite.setTexture(texture);
+        sf::FloatRect spriteBounds = sprite.getLocalBounds();
+        sprite.setScale(24.0f / spriteBounds.width, 24.0f / spriteBounds.height);
+        sprite.setOrigin(spriteBounds.width / 2, spriteBounds.height / 2);
+    }
+}
+
+SnapshotRenderer::SnapshotRenderer() {
+    setupBallSprite(ballSprite, getSharedTexture("assets/ball.png"));
+    setupBallSprite(bonusBallSprite, getSharedTexture("assets/bonus_ball.png"));
+
+    paddleShape.setFillColor(sf::Color::Blue);
+    paddleShape.setOutlineThickness(outlineThickness);
+    paddleShape.setOutlineColor(sf::Color::White);
+
+    bonusShape.setOutlineThickness(outlineThickness);
+    bonusShape.setOutlineColor(sf::Color::Black);
+}
+
+void SnapshotRenderer::draw(sf::RenderWindow& window, const WorldSnapshot& snapshot) {
+    {
+        TraceScope scope("DrawBlocks", "render");
+        if (snapshot.blockLayout != cachedLayout || snapshot.blockHits != cachedHits) {
+            rebuildBlocks(snapshot);
+        }
+        window.draw(blockVertices, sf::Transform().translate(0.0f, snapshot.blockScroll));
+    }
+
+    paddleShape.setPosition(snapshot.paddlePosition);
+    paddleShape.setSize(snapshot.paddleSize);
+    window.draw(paddleShape);
+
+    {
+        TraceScope scope("DrawBalls", "render");
+        for (const auto& ball : snapshot.balls) {
+            sf::Sprite& sprite = ball.bonusBall ? bonusBallSprite : ballSprite;
+            sprite.setPosition(ball.position);
+            window.draw(sprite);
+        }
+    }
+
+    TraceScope scope("DrawBonuses", "render");
+    for (const auto& bonus : snapshot.bonuses) {
+        bonusShape.setPosition(bonus.bounds.left + outlineThickness, bonus.bounds.top + outlineThickness);
+        bonusShape.setSize({ bonus.bounds.width - 2 * outlineThickness, bonus.bounds.height - 2 * outlineThickness });
+        bonusShape.setFillColor(bonus.color);
+        window.draw(bonusShape);
+    }
+}
+
+// Block geometry is baked into one vertex array and only rebuilt when a block is hit
+void SnapshotRenderer::rebuildBlocks(const WorldSnapshot& snapshot) {
+    TraceScope scope("RebuildBlockVertices", "render");
+    cachedLayout = snapshot.blockLayout;
+    cachedHits = snapshot.blockHits;
+    blockVertices.clear();
+    if (!cachedLayout) {
+        return;
+    }
+    for (size_t i = 0; i < cachedLayout->blocks.size() && i < cachedHits.size(); ++i) {
+        if (!cachedHits[i]) continue;
+        const auto& block = cachedLayout->blocks[i];
+        sf::Color color = block.color;
+        if (cachedHits[i] < block.hitPoints) {
+            float shade = 0.4f + 0.6f * cachedHits[i] / block.hitPoints;
+            color = sf::Color(static_cast<sf::Uint8>(color.r * shade), static_cast<sf::Uint8>(color.g * shade),
+                static_cast<sf::Uint8>(color.b * shade));
+        }
+        sf::FloatRect inner(block.bounds.left + block.outline, block.bounds.top + block.outline,
+            block.bounds.width - 2 * block.outline, block.bounds.height - 2 * block.outline);
+        appendQuad(blockVertices, block.bounds, sf::Color::Black);
+        appendQuad(blockVertices, inner, color);
+    }
+}
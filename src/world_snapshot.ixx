@@ -0,0 +1,95 @@
+export module world_snapshot;
+
+import <SFML/Graphics.hpp>;
+import <array>;
+import <atomic>;
+import <cstdint>;
+import <memory>;
+import <vector>;
+
+export struct BlockView {
+    sf::FloatRect bounds;
+    sf::Color color;
+    float outline = 2.0f;
+    std::uint8_t hitPoints = 1; // When the level started; damaged blocks are drawn darker
+};
+
+// Block geometry only changes when a level is (re)loaded or an endless row is refilled, so it
+// is shared between snapshots
+export struct BlockLayout {
+    std::vector<BlockView> blocks;
+};
+
+export struct BallView {
+    sf::Vector2f position;
+    bool bonusBall = false;
+};
+
+export struct BonusView {
+    sf::FloatRect bounds;
+    sf::Color color;
+};
+
+// Immutable copy of everything the renderer needs from one simulation tick
+export struct WorldSnapshot {
+    std::uint64_t tick = 0;
+    sf::Vector2f paddlePosition;
+    sf::Vector2f paddleSize;
+    std::vector<BallView> balls;
+    std::vector<BonusView> bonuses;
+    std::shared_ptr<const BlockLayout> blockLayout;
+    std::vector<std::uint8_t> blockHits; // Hits remaining, 0 once destroyed; indexed like blockLayout->blocks
+    float blockScroll = 0.0f; // Distance every block moved down since blockLayout was built
+    int score = 0;
+    int lives = 0;
+};
+
+// Single-producer/single-consumer handoff: the writer never waits for the reader and the
+// reader always sees the most recently published buffer
+export template<typename T>
+class TripleBuffer {
+public:
+    T& writeBuffer() { return buffers[writeIndex]; }
+
+    void publish() {
+        writeIndex = middle.exchange(static_cast<std::uint8_t>(writeIndex | freshBit), std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Returns true if a newer buffer was published since the last fetch
+    bool fetch() {
+        if ((middle.load(std::memory_order_acquire) & freshBit) == 0) {
+            return false;
+        }
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return buffers[readIndex]; }
+
+private:
+    static constexpr std::uint8_t indexMask = 0x3;
+    static constexpr std::uint8_t freshBit = 0x4;
+
+    std::array<T, 3> buffers{};
+    std::atomic<std::uint8_t> middle{ 1 };
+    std::uint8_t writeIndex = 0;
+    std::uint8_t readIndex = 2;
+};
+
+// Draws a snapshot without touching live game objects, so it is safe to use while the
+// simulation thread is stepping the world
+export class SnapshotRenderer {
+public:
+    SnapshotRenderer();
+    void draw(sf::RenderWindow& window, const WorldSnapshot& snapshot);
+private:
+    sf::Sprite ballSprite;
+    sf::Sprite bonusBallSprite;
+    sf::RectangleShape paddleShape;
+    sf::RectangleShape bonusShape;
+    sf::VertexArray blockVertices{ sf::Triangles };
+    std::shared_ptr<const BlockLayout> cachedLayout;
+    std::vector<std::uint8_t> cachedHits;
+
+    void rebuildBlocks(const WorldSnapshot& snapshot);
+};
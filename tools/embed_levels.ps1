@@ -0,0 +1,34 @@
+# Writes the campaign compiled into the game (see src/embedded_levels.ixx) from the
+# assets/levelN.txt files, each wrapped in a raw string literal, in level number order.
+# Run by the PreBuildEvent of ProjectArkanoid.vcxproj; the output is only rewritten when it
+# changes, so an unchanged campaign does not rebuild the modules that import it.
+param(
+    [Parameter(Mandatory = $true)][string]$AssetDirectory,
+    [Parameter(Mandatory = $true)][string]$Output
+)
+$ErrorActionPreference = 'Stop'
+
+$pattern = '^level(\d+)\.txt$'
+$levels = @(Get-ChildItem -LiteralPath $AssetDirectory -File |
+    Where-Object { $_.Name -match $pattern } |
+    Sort-Object { [int]($_.Name -replace $pattern, '$1') })
+if ($levels.Count -eq 0) {
+    throw "No level files in $AssetDirectory"
+}
+
+$builder = New-Object System.Text.StringBuilder
+[void]$builder.Append("// Generated from assets/levelN.txt by tools/embed_levels.ps1 before every build; do not edit`n")
+foreach ($level in $levels) {
+    $text = [System.IO.File]::ReadAllText($level.FullName) -replace "`r`n", "`n"
+    if ($text.Contains(')level"')) {
+        throw "$($level.Name) contains the raw string delimiter )level`""
+    }
+    [void]$builder.Append("// $($level.Name)`nR`"level($text)level`",`n")
+}
+$content = $builder.ToString()
+
+if ((Test-Path -LiteralPath $Output) -and ([System.IO.File]::ReadAllText($Output) -eq $content)) {
+    exit 0
+}
+[System.IO.File]::WriteAllText($Output, $content, (New-Object System.Text.UTF8Encoding $false))
+Write-Host "Embedded $($levels.Count) levels in $Output"
@@ -0,0 +1,248 @@
+// Offline leaderboard rebuild: reads every player history in parallel and writes the global
+// leaderboard plus one leaderboard per level, in the format the game loads. The player index
+// is rewritten as well, and players still in the old flat layout are moved into shards first.
+//
+//   RebuildLeaderboard [--players DIR] [--output FILE] [--level-dir DIR] [--top N]
+//                      [--threads N] [--synthesize N]
+//
+// --synthesize N first writes N made-up players into the players directory (in all three
+// history formats), for measuring throughput; point --players at a scratch directory.
+
+import <algorithm>;
+import <chrono>;
+import <cstdint>;
+import <filesystem>;
+import <iomanip>;
+import <iostream>;
+import <stdexcept>;
+import <string>;
+import <thread>;
+import <vector>;
+import durable_file;
+import leaderboard_file;
+import player_history;
+import player_store;
+import worker_pool;
+
+namespace {
+    struct Options {
+        std::string playersDirectory = "players";
+        std::string outputFile = "assets/highscores.txt";
+        std::string levelDirectory = "assets/leaderboards";
+        std::size_t top = 10;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        int synthesize = 0;
+    };
+
+    struct LevelRecord {
+        int level = 0;
+        int score = 0;
+        std::uint32_t player = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    Options parseOptions(int argc, char* argv[]) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for option: " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--players") {
+                options.playersDirectory = value();
+            }
+            else if (arg == "--output") {
+                options.outputFile = value();
+            }
+            else if (arg == "--level-dir") {
+                options.levelDirectory = value();
+            }
+            else if (arg == "--top") {
+                options.top = std::stoul(value());
+            }
+            else if (arg == "--threads") {
+                options.threads = std::max(1, std::stoi(value()));
+            }
+            else if (arg == "--synthesize") {
+                options.synthesize = std::stoi(value());
+            }
+            else {
+                throw std::runtime_error("Unknown option: " + arg);
+            }
+        }
+        return options;
+    }
+
+    // Sorts each of the pool's slices on its own thread, then merges neighbouring runs
+    // pairwise, also in parallel, until one sorted run is left
+    template<typename T, typename Compare>
+    void parallelSort(WorkerPool& pool, std::vector<T>& items, Compare compare) {
+        std::size_t slices = pool.concurrency();
+        if (slices < 2 || items.size() < 4096) {
+            std::sort(items.begin(), items.end(), compare);
+            return;
+        }
+        std::vector<std::size_t> bounds(slices + 1);
+        for (std::size_t i = 0; i <= slices; ++i) {
+            bounds[i] = items.size() * i / slices;
+        }
+        pool.parallelFor(slices, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                std::sort(items.begin() + bounds[i], items.begin() + bounds[i + 1], compare);
+            }
+        });
+        for (std::size_t width = 1; width < slices; width *= 2) {
+            std::size_t merges = (slices + 2 * width - 1) / (2 * width);
+            pool.parallelFor(merges, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t merge = begin; merge < end; ++merge) {
+                    std::size_t first = merge * 2 * width;
+                    std::size_t middle = std::min(first + width, slices);
+                    std::size_t last = std::min(first + 2 * width, slices);
+                    if (middle < last) {
+                        std::inplace_merge(items.begin() + bounds[first], items.begin() + bounds[middle],
+                            items.begin() + bounds[last], compare);
+                    }
+                }
+            });
+        }
+    }
+
+    void synthesizePlayers(WorkerPool& pool, const Options& options) {
+        std::filesystem::create_directories(options.playersDirectory);
+        auto start = Clock::now();
+        pool.parallelFor(static_cast<std::size_t>(options.synthesize), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                std::uint64_t state = i * 0x9E3779B97F4A7C15ull + 1;
+                auto next = [&state](int range) {
+                    state ^= state << 13;
+                    state ^= state >> 7;
+                    state ^= state << 17;
+                    return static_cast<int>(state % static_cast<std::uint64_t>(range));
+                };
+                std::string history;
+                int games = 1 + next(40);
+                for (int game = 0; game < games; ++game) {
+                    int level = 1 + next(10);
+                    int score = next(200) * 100;
+                    switch (i % 3) {
+                    case 0: history += playerHistoryLine(level, score); break;
+                    case 1: history += std::to_string(level) + ": " + std::to_string(score) + "\n"; break;
+                    default: history += std::to_string(score) + "\n"; break;
+                    }
+                }
+                std::filesystem::path tail = playerBasePath(options.playersDirectory, "P" + std::to_string(i)) + ".txt";
+                std::filesystem::create_directories(tail.parent_path());
+                appendToFile(tail.string(), history, false);
+            }
+        });
+        std::cout << "Synthesized " << options.synthesize << " players in " << std::fixed << std::setprecision(2)
+            << secondsSince(start) << " s\n";
+    }
+
+    void writeLeaderboard(const std::string& path, const std::vector<std::pair<std::string, int>>& entries) {
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent);
+        }
+        writeFileAtomically(path, serializeLeaderboard(entries), true);
+    }
+
+    int run(const Options& options) {
+        WorkerPool pool(options.threads - 1);
+        if (options.synthesize > 0) {
+            synthesizePlayers(pool, options);
+        }
+
+        auto totalStart = Clock::now();
+        auto phaseStart = totalStart;
+        migrateFlatPlayers(options.playersDirectory);
+        std::vector<std::string> nicknames = listPlayers(options.playersDirectory);
+        double listSeconds = secondsSince(phaseStart);
+
+        phaseStart = Clock::now();
+        std::vector<PlayerHistory> histories(nicknames.size());
+        pool.parallelFor(nicknames.size(), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                histories[i] = loadPlayerHistory(options.playersDirectory, nicknames[i]);
+            }
+        });
+        double scanSeconds = secondsSince(phaseStart);
+
+        phaseStart = Clock::now();
+        std::vector<std::pair<std::string, int>> indexEntries;
+        std::vector<std::pair<std::string, int>> players;
+        std::vector<LevelRecord> levelRecords;
+        std::uint64_t games = 0;
+        for (std::size_t i = 0; i < histories.size(); ++i) {
+            indexEntries.emplace_back(nicknames[i], histories[i].bestScore());
+            if (histories[i].empty()) continue;
+            players.emplace_back(nicknames[i], histories[i].bestScore());
+            games += histories[i].gamesPlayed();
+            // Level 0 holds games from old histories that did not record the level
+            for (const auto& stats : histories[i].levels) {
+                if (stats.level > 0) {
+                    levelRecords.push_back({ stats.level, stats.best, static_cast<std::uint32_t>(i) });
+                }
+            }
+        }
+        parallelSort(pool, players, [](const auto& a, const auto& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        });
+        parallelSort(pool, levelRecords, [&nicknames](const LevelRecord& a, const LevelRecord& b) {
+            if (a.level != b.level) return a.level < b.level;
+            if (a.score != b.score) return a.score > b.score;
+            return nicknames[a.player] < nicknames[b.player];
+        });
+        double sortSeconds = secondsSince(phaseStart);
+
+        phaseStart = Clock::now();
+        writeFileAtomically(playerIndexPath(options.playersDirectory), serializePlayerIndex(indexEntries), true);
+        std::size_t rankedPlayers = players.size();
+        players.resize(std::min(players.size(), options.top));
+        writeLeaderboard(options.outputFile, players);
+        int levelFiles = 0;
+        for (std::size_t first = 0; first < levelRecords.size(); ) {
+            int level = levelRecords[first].level;
+            std::vector<std::pair<std::string, int>> entries;
+            std::size_t next = first;
+            for (; next < levelRecords.size() && levelRecords[next].level == level; ++next) {
+                if (entries.size() < options.top) {
+                    entries.emplace_back(nicknames[levelRecords[next].player], levelRecords[next].score);
+                }
+            }
+            writeLeaderboard(options.levelDirectory + "/level" + std::to_string(level) + ".txt", entries);
+            ++levelFiles;
+            first = next;
+        }
+        double writeSeconds = secondsSince(phaseStart);
+        double totalSeconds = secondsSince(totalStart);
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "Players: " << nicknames.size() << " files, " << games << " games, " << pool.concurrency() << " threads\n"
+            << "List:  " << listSeconds << " s\n"
+            << "Scan:  " << scanSeconds << " s (" << std::setprecision(0) << nicknames.size() / std::max(scanSeconds, 1e-9) << " files/s)\n"
+            << std::setprecision(3)
+            << "Sort:  " << sortSeconds << " s (" << rankedPlayers << " players, " << levelRecords.size() << " level records)\n"
+            << "Write: " << writeSeconds << " s (" << options.outputFile << " and " << levelFiles << " level leaderboards in " << options.levelDirectory << ", player index)\n"
+            << "Total: " << totalSeconds << " s\n";
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        return run(parseOptions(argc, argv));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}